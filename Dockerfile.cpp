@@ -15,13 +15,10 @@ RUN apt-get update && apt-get install -y \
 WORKDIR /app
 
 # Copy source files
-COPY cpp-arbitrage-engine.cpp cpp-types-header.h ./
-
-# Copy main file
-COPY main.cpp ./
+COPY *.cpp *.h ./
 
 # Build the application
-RUN g++ -std=c++17 -O3 -o arbitrage_scanner main.cpp cpp-arbitrage-engine.cpp
+RUN g++ -std=c++17 -O3 -o arbitrage_scanner main.cpp cpp-arbitrage-engine.cpp cycle_detector.cpp detection_pool.cpp feed_simulator.cpp http_server.cpp tick_journal.cpp graph_snapshot.cpp feed_handler.cpp thread_topology.cpp -lpthread
 
 # Expose port
 EXPOSE 8080 9090
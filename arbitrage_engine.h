@@ -2,20 +2,28 @@
 #pragma once
 
 #include "cpp-types-header.h"
+#include "cross_exchange_scanner.h"
+#include "cycle_detector.h"
+#include "detection_pool.h"
+#include "double_buffered_graph.h"
+#include "graph_snapshot.h"
+#include "opportunity_dedup.h"
+#include "opportunity_ring.h"
+#include "order_book.h"
+#include "sparse_graph.h"
+#include "spsc_queue.h"
+#include "symbol_table.h"
+#include "thread_topology.h"
+#include "tick_journal.h"
+#include <condition_variable>
 #include <functional>
-#include <array>
+#include <memory>
 #include <unordered_map>
 #include <thread>
 #include <mutex>
 #include <optional>
 #include <pthread.h>
 
-// Forward declaration for the third-party library
-namespace moodycamel {
-    template<typename T>
-    class ReaderWriterQueue;
-}
-
 namespace arbitrage {
 
 // Forward declarations
@@ -33,43 +41,129 @@ private:
     Config config_;
     std::atomic<bool> running_;
     PerformanceStats stats_;
+
+    // Topology-aware role-to-cpu assignment (see thread_topology.h),
+    // computed before any of the big members below. ctor_affinity_ pins
+    // the constructing thread to the processing core for the rest of the
+    // constructor, so the graph buffers and ingestion rings first-touch
+    // their pages on the processing thread's NUMA node; the constructor
+    // body releases it.
+    ThreadTopology topology_;
+    ThreadPlacement placement_;
+    ScopedAffinity ctor_affinity_;
+
+
+    // Sparse price graph for Bellman-Ford algorithm (per-vertex CSR rows),
+    // double-buffered so detection always scans an immutable snapshot
+    // (see double_buffered_graph.h)
+    DoubleBufferedGraph price_graph_;
+
+    // Dirty-vertex tracking for incremental detection: update_price_graph()
+    // flags the endpoints of changed edges, the detector drains the flags and
+    // only re-relaxes from those sources between periodic full scans.
+    std::vector<std::atomic<uint8_t>> dirty_vertices_;
+    std::atomic<uint64_t> dirty_count_;
+    Timestamp last_full_scan_;
+
+    // Parallel negative-cycle search: sources are sharded across pinned
+    // workers, each running the configured backend (see detection_pool.h)
+    DetectionPool detection_pool_;
     
-    // Price graph for Bellman-Ford algorithm
-    std::array<std::array<double, MAX_EXCHANGES * MAX_SYMBOLS>, 
-               MAX_EXCHANGES * MAX_SYMBOLS> price_graph_;
-    
-    // Currency indexing
-    std::unordered_map<std::string, size_t> currency_indices_;
-    std::unordered_map<size_t, std::string> currency_names_;
+    // Currency interning: (exchange, currency) -> dense vertex id with
+    // allocation-free hot-path lookups (see symbol_table.h)
+    SymbolTable symbols_;
     
     // Threading
     std::thread processing_thread_;
     std::thread detection_thread_;
-    std::atomic<Timestamp> last_update_time_;
+    std::atomic<uint64_t> last_update_time_ns_;
+    // Oldest tick in the most recently applied batch; anchor for the
+    // tick-to-alert latency measurement
+    std::atomic<uint64_t> last_batch_oldest_ns_;
     std::atomic<uint64_t> sequence_counter_;
     
-    // Lock-free queue for market data
-    moodycamel::ReaderWriterQueue<MarketTick>* tick_queue_;
+    // Per-exchange ingestion rings (see spsc_queue.h): each feed thread
+    // produces into its own shard, keeping every ring strictly
+    // single-producer and removing cross-exchange head-of-line blocking.
+    // The processing thread round-robin drains them.
+    std::vector<std::unique_ptr<SpscQueue<MarketTick>>> tick_queues_;
+    size_t drain_rotation_; // processing thread only
+
+    // Depth updates ride the same sharded pipeline as ticks (one SPSC
+    // ring per exchange feed thread); the processing thread applies them
+    // to the flat book store, which detection reads lock-free
+    std::vector<std::unique_ptr<SpscQueue<DepthUpdate>>> depth_queues_;
+    OrderBookStore order_books_;
+
+    // Additive log-space taker-fee penalty per ingestion shard, resolved
+    // once at construction from Config::Fees (see fee_model.h); the edge
+    // update path applies it branch-free
+    double fee_log_penalty_[NUM_EXCHANGE_SHARDS];
+
+    // Consumer parking for the HYBRID wait strategy: the processing thread
+    // only parks after spinning and yielding, and producers only touch the
+    // condvar when the parked flag is set (one relaxed load otherwise)
+    std::mutex wakeup_mutex_;
+    std::condition_variable wakeup_cv_;
+    std::atomic<bool> consumer_parked_;
+
+    // Recycled struct-of-arrays batches for the coalescing/graph-update
+    // pass (see TickBatch in cpp-types-header.h)
+    MemoryPool<TickBatch, 8> tick_batch_pool_;
     
-    // Opportunity storage and callbacks
-    mutable std::mutex opportunities_mutex_;
-    std::vector<ArbitrageOpportunity> detected_opportunities_;
+    // Optional tick persistence: the processing thread mirrors every
+    // dequeued tick here (see tick_journal.h). Set before start().
+    JournalWriter* tick_journal_;
+
+    // Periodic warm-restart snapshots (see graph_snapshot.h); written by
+    // the processing thread, which owns all graph writes
+    uint64_t last_snapshot_ns_;
+
+    // Repeat-cycle suppression, detection thread only (see
+    // opportunity_dedup.h)
+    OpportunityDedup opportunity_dedup_;
+
+    // Two-leg cross-exchange spread fast path, processing thread only:
+    // checked inline on every quote update so these opportunities never
+    // wait for the 10ms detection cadence (see cross_exchange_scanner.h)
+    CrossExchangeScanner cross_scanner_;
+
+    // Alert rate limiting; shared by the detection thread and the
+    // cross-exchange fast path, hence atomic
+    std::atomic<uint64_t> alert_window_s_;
+    std::atomic<uint32_t> alerts_in_window_;
+
+    // Opportunity storage (lock-free; see opportunity_ring.h) and callbacks
+    OpportunityRing opportunity_ring_;
     mutable std::mutex callback_mutex_;
     std::vector<OpportunityCallback> callbacks_;
     
     // Helper methods
     void process_market_data();
-    void update_price_graph(const MarketTick& tick);
+    void coalesce_into_batch(const MarketTick* ticks, size_t n,
+                             TickBatch& batch);
+    void apply_batch(const TickBatch& batch);
+    void update_price_graph(uint16_t base_id, uint16_t quote_id,
+                            uint16_t pair_id, Price bid, Price ask,
+                            uint8_t shard);
+    void emit_cross_exchange(const CrossExchangeScanner::Spread& spread);
     void detect_arbitrage_opportunities();
-    std::vector<ArbitrageOpportunity> find_negative_cycles();
-    std::optional<ArbitrageOpportunity> extract_arbitrage_cycle(
-        int cycle_node, 
-        const std::vector<int>& parent, 
-        const std::vector<double>& dist);
-    uint32_t calculate_confidence(const std::vector<int>& path, double log_return) const;
+    std::vector<ArbitrageOpportunity> find_negative_cycles(
+        const SparsePriceGraph& graph, uint64_t min_updated_ns);
+    std::vector<ArbitrageOpportunity> find_negative_cycles_from(
+        const SparsePriceGraph& graph, const std::vector<size_t>& sources,
+        uint64_t min_updated_ns);
+    std::vector<size_t> drain_dirty_vertices();
+    void mark_vertex_dirty(size_t v);
+    void idle_wait(uint32_t& idle_count);
+    void drain_depth_queues();
+    void maybe_save_snapshot();
+    std::optional<ArbitrageOpportunity> build_opportunity(
+        const SparsePriceGraph& graph, const Cycle& cycle);
+    uint32_t calculate_confidence(const std::vector<int>& path, double log_return,
+                                  uint64_t max_edge_age_ms) const;
     Volume estimate_max_volume(const std::vector<int>& path) const;
-    std::optional<std::pair<std::string, std::string> > parse_symbol(const std::string& symbol);
-    size_t get_currency_index(const std::string& currency, uint8_t exchange);
+    bool resolve_symbol_ids(MarketTick& tick);
     std::string get_currency_name(size_t index) const;
     void on_opportunity_detected(const ArbitrageOpportunity& opportunity);
 
@@ -80,17 +174,39 @@ public:
     // Control methods
     void start();
     void stop();
+
+    // Cpu assignments for the engine's own threads plus the feed and
+    // server roles; main() pins those alongside the engine's
+    const ThreadPlacement& placement() const { return placement_; }
     
-    // Market data interface
+    // Market data interface. The (pointer, length) overload is the hot
+    // one: feed handlers call it straight off a parsed wire message with
+    // no intermediate std::string.
+    bool update_price(Exchange exchange, const char* symbol, size_t symbol_len,
+                     Price bid, Price ask, Volume volume);
     bool update_price(Exchange exchange, const std::string& symbol,
                      Price bid, Price ask, Volume volume);
+
+    // Order-book depth interface: replaces both sides of the pair's book.
+    // Levels must be best-first; at most DEPTH_LEVELS per side are kept.
+    bool update_depth(Exchange exchange, const std::string& symbol,
+                      const DepthLevel* bids, size_t bid_count,
+                      const DepthLevel* asks, size_t ask_count);
     
     // Callback registration
     void register_opportunity_callback(OpportunityCallback callback);
+
+    // Attach an open journal writer (or nullptr to detach). Must be
+    // called before start(); the pointer is read by the processing thread
+    // without synchronization.
+    void set_tick_journal(JournalWriter* journal);
     
     // Query methods
     std::vector<ArbitrageOpportunity> get_recent_opportunities(size_t limit) const;
-    PerformanceStats get_performance_stats() const;
+    // Monotonic counter of stored opportunities; lets consumers skip
+    // re-serialization when nothing changed
+    uint64_t opportunity_generation() const;
+    PerformanceStats::Snapshot get_performance_stats() const;
 };
 
 } // namespace arbitrage
\ No newline at end of file
@@ -0,0 +1,223 @@
+// bench_engine.cpp - Microbenchmarks for the arbitrage engine hot paths
+//
+// Build (needs Google Benchmark, https://github.com/google/benchmark):
+//
+//   g++ -std=c++17 -O3 -I.. bench_engine.cpp ../cycle_detector.cpp \
+//       -lbenchmark -lpthread -o bench_engine
+//
+// Emit machine-readable results for regression tracking with:
+//
+//   ./bench_engine --benchmark_format=json > results.json
+
+#include "cycle_detector.h"
+#include "price_math.h"
+#include "simd_relax.h"
+#include "sparse_graph.h"
+#include "spsc_queue.h"
+#include "symbol_table.h"
+
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+namespace {
+
+using namespace arbitrage;
+
+// Build a random sparse graph with `vertices` vertices and ~`edges` edges,
+// weights near zero (log-price scale) with no guaranteed negative cycle.
+SparsePriceGraph make_graph(size_t vertices, size_t edges, uint64_t seed = 7) {
+  SparsePriceGraph graph(vertices);
+  std::mt19937_64 rng(seed);
+  std::uniform_int_distribution<size_t> vertex(0, vertices - 1);
+  std::uniform_real_distribution<double> weight(0.0001, 0.01);
+  for (size_t i = 0; i < edges; ++i) {
+    size_t u = vertex(rng);
+    size_t v = vertex(rng);
+    if (u != v) {
+      graph.upsert_edge(u, v, weight(rng));
+    }
+  }
+  return graph;
+}
+
+// Same, but with one guaranteed small negative triangle so the detectors
+// exercise cycle extraction too.
+SparsePriceGraph make_graph_with_cycle(size_t vertices, size_t edges) {
+  SparsePriceGraph graph = make_graph(vertices, edges);
+  graph.upsert_edge(0, 1, -0.004);
+  graph.upsert_edge(1, 2, -0.004);
+  graph.upsert_edge(2, 0, 0.005);
+  return graph;
+}
+
+void BM_GraphUpsert(benchmark::State &state) {
+  const size_t vertices = 256;
+  SparsePriceGraph graph(vertices);
+  std::mt19937_64 rng(7);
+  std::uniform_int_distribution<size_t> vertex(0, vertices - 1);
+  size_t u = 0;
+  for (auto _ : state) {
+    graph.upsert_edge(u, (u + 17) % vertices, 0.001);
+    u = (u + 1) % vertices;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GraphUpsert);
+
+// One full relaxation pass over every live row, at varying edge counts -
+// this is the kernel a Bellman-Ford iteration is made of.
+void BM_RelaxationPass(benchmark::State &state) {
+  const size_t vertices = 128;
+  const size_t edges = static_cast<size_t>(state.range(0));
+  SparsePriceGraph graph = make_graph(vertices, edges);
+
+  std::vector<double> dist(vertices, 0.5);
+  std::vector<int> parent(vertices, -1);
+
+  for (auto _ : state) {
+    for (size_t u = 0; u < vertices; ++u) {
+      benchmark::DoNotOptimize(simd::relax_row(
+          dist[u], graph.row(u), dist.data(), parent.data(),
+          static_cast<int>(u), 0 /* no edge-age cutoff */));
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(graph.edge_count()));
+}
+BENCHMARK(BM_RelaxationPass)->Arg(256)->Arg(1024)->Arg(4096);
+
+void BM_BellmanFordDetect(benchmark::State &state) {
+  const size_t vertices = 64;
+  SparsePriceGraph graph =
+      make_graph_with_cycle(vertices, static_cast<size_t>(state.range(0)));
+  BellmanFordDetector detector;
+  std::vector<size_t> sources;
+  for (size_t v = 0; v < graph.vertex_count(); ++v) {
+    if (graph.is_active(v)) {
+      sources.push_back(v);
+    }
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        detector.find_cycles(graph, sources, 0 /* no edge-age cutoff */));
+  }
+}
+BENCHMARK(BM_BellmanFordDetect)->Arg(128)->Arg(512);
+
+void BM_SpfaDetect(benchmark::State &state) {
+  const size_t vertices = 64;
+  SparsePriceGraph graph =
+      make_graph_with_cycle(vertices, static_cast<size_t>(state.range(0)));
+  SpfaDetector detector;
+  std::vector<size_t> sources;
+  for (size_t v = 0; v < graph.vertex_count(); ++v) {
+    if (graph.is_active(v)) {
+      sources.push_back(v);
+    }
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        detector.find_cycles(graph, sources, 0 /* no edge-age cutoff */));
+  }
+}
+BENCHMARK(BM_SpfaDetect)->Arg(128)->Arg(512);
+
+// Steady-state intern cost: every call is a hit after the first lap.
+void BM_SymbolIntern(benchmark::State &state) {
+  SymbolTable table;
+  static const char *codes[] = {"BTC", "ETH", "USDT", "BNB",
+                                "ADA", "SOL", "XRP",  "DOGE"};
+  size_t i = 0;
+  for (auto _ : state) {
+    const char *code = codes[i & 7];
+    benchmark::DoNotOptimize(
+        table.intern(code, std::strlen(code), static_cast<uint8_t>(i & 3)));
+    ++i;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SymbolIntern);
+
+// Producer-side enqueue cost into the SPSC ring (no consumer; the ring is
+// drained manually when full, so the hot path under test is try_enqueue).
+void BM_TickEnqueue(benchmark::State &state) {
+  SpscQueue<MarketTick> queue(65536);
+  std::vector<MarketTick> sink(4096);
+  MarketTick tick{};
+  tick.bid = 50000.0;
+  tick.ask = 50005.0;
+  for (auto _ : state) {
+    if (!queue.try_enqueue(tick)) {
+      state.PauseTiming();
+      while (queue.try_dequeue_bulk(sink.data(), sink.size()) > 0) {
+      }
+      state.ResumeTiming();
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TickEnqueue);
+
+// Edge weight computation as update_price_graph performs it per tick
+// (quantize, log, fee add), libm baseline vs the fast_log path.
+void BM_EdgeWeightLibm(benchmark::State &state) {
+  std::mt19937_64 rng(7);
+  std::uniform_real_distribution<double> price(0.0001, 70000.0);
+  std::vector<double> prices(1024);
+  for (auto &p : prices) {
+    p = price(rng);
+  }
+  const double fee_penalty = 0.001;
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(-std::log(prices[i & 1023]) + fee_penalty);
+    ++i;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_EdgeWeightLibm);
+
+void BM_EdgeWeightFastLog(benchmark::State &state) {
+  std::mt19937_64 rng(7);
+  std::uniform_real_distribution<double> price(0.0001, 70000.0);
+  std::vector<double> prices(1024);
+  for (auto &p : prices) {
+    p = FixedPrice::from_double(price(rng)).to_double();
+  }
+  const double fee_penalty = 0.001;
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(-fast_log(prices[i & 1023]) + fee_penalty);
+    ++i;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_EdgeWeightFastLog);
+
+// Not a throughput number: sweeps the positive price range on a dense
+// logarithmic grid, reports the worst deviation from std::log as a
+// counter, and fails the run if it breaks the bound documented in
+// price_math.h. Keeps the approximation honest as it gets tweaked.
+void BM_FastLogAccuracy(benchmark::State &state) {
+  double max_abs_err = 0.0;
+  for (auto _ : state) {
+    for (double px = 1e-8; px < 1e7; px *= 1.001) {
+      double err = std::fabs(fast_log(px) - std::log(px));
+      if (err > max_abs_err) {
+        max_abs_err = err;
+      }
+    }
+    benchmark::DoNotOptimize(max_abs_err);
+  }
+  state.counters["max_abs_err"] = max_abs_err;
+  if (max_abs_err > 1e-9) {
+    state.SkipWithError("fast_log error exceeds the 1e-9 bound");
+  }
+}
+BENCHMARK(BM_FastLogAccuracy);
+
+} // namespace
+
+BENCHMARK_MAIN();
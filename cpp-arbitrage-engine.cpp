@@ -1,29 +1,115 @@
 // arbitrage_engine.cpp - Core arbitrage detection algorithms
 #include "arbitrage_engine.h"
+#include "price_math.h"
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <execution>
+#include <iostream>
 #include <limits>
 
+#if defined(__x86_64__)
+#include <immintrin.h> // _mm_pause
+#endif
+
 namespace arbitrage {
 
+namespace {
+
+// enable_triangle_arbitrage trumps the configured backend: bounded
+// enumeration finds every k<=3 (or k<=4) cycle over the live edges in
+// microseconds, and calculate_confidence() prices longer paths out of
+// actionability anyway (see HopLimitedDetector in cycle_detector.h)
+DetectorAlgorithm resolve_detector(const Config::Arbitrage &arb) {
+  return arb.enable_triangle_arbitrage ? DetectorAlgorithm::HOP_LIMITED
+                                       : arb.detector_algorithm;
+}
+
+// Explicit placement slots for the detection pool's extra workers, so none
+// of them lands on the processing core by modulo accident
+std::vector<int> detection_worker_cpus(const ThreadPlacement &placement,
+                                       const Config::Threading &threading) {
+  size_t extra = threading.num_processor_threads > 1
+                     ? static_cast<size_t>(threading.num_processor_threads) - 1
+                     : 0;
+  std::vector<int> cpus;
+  cpus.reserve(extra);
+  for (size_t i = 0; i < extra; ++i) {
+    cpus.push_back(placement.cpu_for(ThreadRole::DETECTION_WORKER, i));
+  }
+  return cpus;
+}
+
+} // namespace
+
 ArbitrageEngine::ArbitrageEngine(const Config &config)
     : config_(config), running_(false), stats_{},
+      placement_(config.threading, topology_),
+      ctor_affinity_(placement_.cpu_for(ThreadRole::PROCESSING)),
       price_graph_(MAX_EXCHANGES * MAX_SYMBOLS),
-      last_update_time_(std::chrono::high_resolution_clock::now()),
-      sequence_counter_(0), tick_queue_(nullptr) {
-  // Initialize exchange rate graph with infinity
-  for (auto &row : price_graph_) {
-    std::fill(row.begin(), row.end(), std::numeric_limits<double>::infinity());
+      dirty_vertices_(MAX_EXCHANGES * MAX_SYMBOLS), dirty_count_(0),
+      last_full_scan_(std::chrono::high_resolution_clock::now()),
+      detection_pool_(config.threading, resolve_detector(config.arbitrage),
+                      config.arbitrage.max_cycle_length,
+                      detection_worker_cpus(placement_, config.threading)),
+      last_update_time_ns_(monotonic_ns()), last_batch_oldest_ns_(0),
+      sequence_counter_(0), drain_rotation_(0), consumer_parked_(false),
+      tick_journal_(nullptr), last_snapshot_ns_(monotonic_ns()),
+      opportunity_dedup_(config.arbitrage.dedup_ttl_ms),
+      cross_scanner_(MAX_EXCHANGES * MAX_SYMBOLS, config.fees,
+                     config.arbitrage.min_profit_threshold,
+                     config.arbitrage.dedup_ttl_ms),
+      alert_window_s_(0), alerts_in_window_(0) {
+  // The sparse graph starts empty; edges appear as ticks arrive, so there is
+  // no dense matrix to pre-fill with infinity anymore.
+  for (auto &flag : dirty_vertices_) {
+    flag.store(0, std::memory_order_relaxed);
+  }
+
+  // Resolve each shard's fee schedule to its log penalty once; the edge
+  // update path never evaluates fee models
+  for (size_t i = 0; i < NUM_EXCHANGE_SHARDS; ++i) {
+    fee_log_penalty_[i] = fee_log_penalty(config_.fees.schedule[i]);
   }
 
-  // Set diagonal to zero (no cost to convert currency to itself)
-  for (size_t i = 0; i < price_graph_.size(); ++i) {
-    price_graph_[i][i] = 0.0;
+  tick_queues_.reserve(NUM_EXCHANGE_SHARDS);
+  depth_queues_.reserve(NUM_EXCHANGE_SHARDS);
+  for (size_t i = 0; i < NUM_EXCHANGE_SHARDS; ++i) {
+    tick_queues_.push_back(std::make_unique<SpscQueue<MarketTick>>(
+        config.threading.queue_capacity));
+    // Depth updates are fat (both book sides) but far less frequent than
+    // ticks, so the rings can be much shorter
+    depth_queues_.push_back(std::make_unique<SpscQueue<DepthUpdate>>(
+        config.threading.queue_capacity / 16));
   }
 
-  // Pre-allocate opportunity storage
-  detected_opportunities_.reserve(1000);
+  // Warm restart: repopulate the graph and currency index from the last
+  // snapshot instead of running blind until every pair ticks again. A
+  // missing or unreadable snapshot just means a cold start.
+  if (!config_.persistence.snapshot_path.empty()) {
+    uint64_t saved_sequence = 0;
+    size_t restored = 0, skipped = 0;
+    if (GraphSnapshot::restore(config_.persistence.snapshot_path,
+                               price_graph_.writer_buffer(), symbols_,
+                               config_.persistence.max_edge_age_s,
+                               saved_sequence, restored, skipped)) {
+      price_graph_.publish_initial(); // mirror into the read buffer
+      sequence_counter_.store(saved_sequence, std::memory_order_relaxed);
+      // Restored edges should be examined by the first detection pass
+      const SparsePriceGraph &restored_view = price_graph_.writer_view();
+      for (size_t v = 0; v < restored_view.vertex_count(); ++v) {
+        if (restored_view.is_active(v)) {
+          mark_vertex_dirty(v);
+        }
+      }
+      std::cout << "Restored snapshot: " << restored << " edges ("
+                << skipped << " stale), " << symbols_.size()
+                << " currencies\n";
+    }
+  }
+
+  // First-touch allocations are done; give the caller its cpu mask back
+  ctor_affinity_.release();
 }
 
 ArbitrageEngine::~ArbitrageEngine() { stop(); }
@@ -33,16 +119,28 @@ void ArbitrageEngine::start() {
     return; // Already running
   }
 
-  // Start processing thread with core affinity
-  processing_thread_ = std::thread([this] { process_market_data(); });
-
-  // Start opportunity detection thread
-  detection_thread_ = std::thread([this] { detect_arbitrage_opportunities(); });
+  // Both engine threads pin to their placement slots: processing to the
+  // anchor core the ingestion rings were faulted next to, detection to
+  // its own core so a long pass never steals the consumer's cycles
+  processing_thread_ = std::thread([this] {
+    ThreadPlacement::pin_current_thread(
+        placement_.cpu_for(ThreadRole::PROCESSING));
+    process_market_data();
+  });
+
+  detection_thread_ = std::thread([this] {
+    ThreadPlacement::pin_current_thread(
+        placement_.cpu_for(ThreadRole::DETECTION));
+    detect_arbitrage_opportunities();
+  });
 }
 
 void ArbitrageEngine::stop() {
   running_.store(false);
 
+  // Unblock a parked processing thread so it can observe the stop flag
+  wakeup_cv_.notify_all();
+
   if (processing_thread_.joinable()) {
     processing_thread_.join();
   }
@@ -54,87 +152,455 @@ void ArbitrageEngine::stop() {
 
 bool ArbitrageEngine::update_price(Exchange exchange, const std::string &symbol,
                                    Price bid, Price ask, Volume volume) {
-  auto start_time = std::chrono::high_resolution_clock::now();
+  return update_price(exchange, symbol.data(), symbol.size(), bid, ask,
+                      volume);
+}
 
-  // Create market tick
-  MarketTick tick;
+bool ArbitrageEngine::update_price(Exchange exchange, const char *symbol,
+                                   size_t symbol_len, Price bid, Price ask,
+                                   Volume volume) {
+  uint64_t start_ns = monotonic_ns();
+
+  // Create market tick (value-init zeroes the struct; no constructor work)
+  MarketTick tick{};
   tick.exchange = exchange;
-  std::strncpy(tick.symbol, symbol.c_str(), sizeof(tick.symbol) - 1);
+  std::memcpy(tick.symbol, symbol,
+              std::min(symbol_len, sizeof(tick.symbol) - 1));
   tick.bid = bid;
   tick.ask = ask;
-  tick.last_price = (bid + ask) / 2.0;
   tick.volume = volume;
-  tick.timestamp = start_time;
+  tick.timestamp_ns = start_ns;
   tick.sequence = sequence_counter_.fetch_add(1);
 
-  // Try to enqueue - if queue is full, drop oldest messages (backpressure)
-  if (tick_queue_ != nullptr) {
-    bool success = tick_queue_->try_enqueue(tick);
+  // Resolve currency ids here, once, so the processing thread never touches
+  // strings. Malformed symbols are rejected before they reach the queue.
+  if (!resolve_symbol_ids(tick)) {
+    return false;
+  }
+
+  // Try to enqueue on this exchange's shard - if the ring is full the
+  // tick is dropped (backpressure), charged to the shard that overflowed
+  size_t shard = exchange_shard(exchange);
+  bool success = tick_queues_[shard]->try_enqueue(tick);
+  if (!success) {
+    stats_.shard_counters[shard].ticks_dropped.fetch_add(
+        1, std::memory_order_relaxed);
+  }
+
+  if (success) {
+    // Per-shard padded counter: this producer owns the line, so the add
+    // never bounces between feed threads
+    stats_.shard_counters[shard].ticks_ingested.fetch_add(
+        1, std::memory_order_relaxed);
+
+    // Wake a parked consumer; in the common (non-parked) case this is a
+    // single relaxed load and no syscall
+    if (consumer_parked_.load(std::memory_order_acquire)) {
+      wakeup_cv_.notify_one();
+    }
+
+    // Update latency statistics
+    uint64_t latency_ns = monotonic_ns() - start_ns;
+    stats_.record_stage(STAGE_ENQUEUE, latency_ns);
+    stats_.update_latency(static_cast<double>(latency_ns) / 1000.0);
+  }
+
+  return success;
+}
+
+bool ArbitrageEngine::update_depth(Exchange exchange,
+                                   const std::string &symbol,
+                                   const DepthLevel *bids, size_t bid_count,
+                                   const DepthLevel *asks, size_t ask_count) {
+  // Resolve pair ids at the edge, like update_price does for ticks
+  auto slash = symbol.find('/');
+  if (slash == std::string::npos || slash == 0 ||
+      slash + 1 >= symbol.size()) {
+    return false;
+  }
+  uint8_t exch = static_cast<uint8_t>(exchange);
+  CurrencyId base_id = symbols_.intern(symbol.data(), slash, exch);
+  CurrencyId quote_id =
+      symbols_.intern(symbol.data() + slash + 1, symbol.size() - slash - 1,
+                      exch);
+  if (base_id == INVALID_CURRENCY_ID || quote_id == INVALID_CURRENCY_ID) {
+    return false;
+  }
+
+  DepthUpdate update{};
+  update.base_id = base_id;
+  update.quote_id = quote_id;
+  update.bid_count = static_cast<uint8_t>(std::min(bid_count, DEPTH_LEVELS));
+  update.ask_count = static_cast<uint8_t>(std::min(ask_count, DEPTH_LEVELS));
+  std::memcpy(update.bids, bids, update.bid_count * sizeof(DepthLevel));
+  std::memcpy(update.asks, asks, update.ask_count * sizeof(DepthLevel));
+
+  return depth_queues_[exchange_shard(exchange)]->try_enqueue(update);
+}
+
+void ArbitrageEngine::drain_depth_queues() {
+  DepthUpdate update;
+  for (auto &queue : depth_queues_) {
+    while (queue->try_dequeue(update)) {
+      order_books_.apply(update);
+    }
+  }
+}
+
+void ArbitrageEngine::idle_wait(uint32_t &idle_count) {
+  switch (config_.threading.wait_strategy) {
+  case WaitStrategy::BUSY_SPIN:
+#if defined(__x86_64__)
+    _mm_pause();
+#else
+    std::this_thread::yield();
+#endif
+    return;
+
+  case WaitStrategy::SLEEP:
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+    return;
+
+  case WaitStrategy::HYBRID:
+  default:
+    break;
+  }
 
-    if (success) {
-      stats_.messages_processed.fetch_add(1);
+  // HYBRID: spin (cheapest wakeup), then yield (share the core), then park
+  // (no CPU at all) - escalating with consecutive empty polls
+  ++idle_count;
+  if (idle_count <= config_.threading.spin_iterations) {
+#if defined(__x86_64__)
+    _mm_pause();
+#else
+    std::this_thread::yield();
+#endif
+    return;
+  }
+
+  if (idle_count <=
+      config_.threading.spin_iterations + config_.threading.yield_iterations) {
+    std::this_thread::yield();
+    return;
+  }
 
-      // Update latency statistics
-      auto end_time = std::chrono::high_resolution_clock::now();
-      auto latency_us = std::chrono::duration_cast<std::chrono::microseconds>(
-                            end_time - start_time)
-                            .count();
-      stats_.update_latency(static_cast<double>(latency_us));
+  std::unique_lock<std::mutex> lock(wakeup_mutex_);
+  consumer_parked_.store(true, std::memory_order_release);
+  // Re-check after publishing the parked flag: a producer that enqueued
+  // just before the store would otherwise be missed
+  bool all_empty = true;
+  for (const auto &queue : tick_queues_) {
+    if (queue->size_approx() != 0) {
+      all_empty = false;
+      break;
     }
-    
-    return success;
   }
-  
-  return false;
+  if (all_empty && running_.load()) {
+    wakeup_cv_.wait_for(lock, std::chrono::milliseconds(1));
+  }
+  consumer_parked_.store(false, std::memory_order_release);
 }
 
 void ArbitrageEngine::process_market_data() {
-  MarketTick tick;
-  const auto wait_time =
-      std::chrono::microseconds(100); // 100μs polling interval
+  uint32_t idle_count = 0;
+  std::vector<MarketTick> stage(TickBatch::CAPACITY);
 
   while (running_.load()) {
-    if (tick_queue_.try_dequeue(tick)) {
-      update_price_graph(tick);
-      last_update_time_.store(tick.timestamp);
-    } else {
-      // No data available, brief sleep to prevent busy waiting
-      std::this_thread::sleep_for(wait_time);
+    // Round-robin drain across the exchange shards, rotating the starting
+    // shard so no exchange gets structural priority when the stage buffer
+    // fills before every shard has been visited
+    size_t n = 0;
+    for (size_t i = 0; i < tick_queues_.size() && n < stage.size(); ++i) {
+      size_t shard = (drain_rotation_ + i) % tick_queues_.size();
+      n += tick_queues_[shard]->try_dequeue_bulk(stage.data() + n,
+                                                 stage.size() - n);
+    }
+    drain_rotation_ = (drain_rotation_ + 1) % tick_queues_.size();
+
+    // Depth updates are applied before the tick batch so volume
+    // estimation for this batch's opportunities sees current books
+    drain_depth_queues();
+
+    if (n == 0) {
+      // No data available; escalate per the configured wait strategy
+      idle_wait(idle_count);
+      continue;
+    }
+    idle_count = 0;
+
+    // Queue residency: how long each tick sat in the ring before the
+    // processing thread saw it
+    uint64_t dequeue_ns = monotonic_ns();
+    for (size_t i = 0; i < n; ++i) {
+      stats_.record_stage(STAGE_QUEUE_WAIT,
+                          dequeue_ns - stage[i].timestamp_ns);
+    }
+
+    // Mirror the raw (pre-coalescing) stream to the journal so a replay
+    // sees exactly what this thread saw
+    if (tick_journal_ != nullptr) {
+      for (size_t i = 0; i < n; ++i) {
+        tick_journal_->record(stage[i]);
+      }
+    }
+
+    // Transpose the drained ticks into a pooled struct-of-arrays batch,
+    // coalescing same-pair updates on the way, then apply it in one pass
+    TickBatch *batch = tick_batch_pool_.acquire();
+    bool pooled = batch != nullptr;
+    TickBatch local_batch; // fallback if all pool batches are in flight
+    if (!pooled) {
+      batch = &local_batch;
     }
+
+    coalesce_into_batch(stage.data(), n, *batch);
+    stats_.ticks_coalesced.fetch_add(n - batch->count);
+    apply_batch(*batch);
+    stats_.record_stage(STAGE_GRAPH_UPDATE, monotonic_ns() - dequeue_ns);
+
+    if (pooled) {
+      tick_batch_pool_.release(batch);
+    }
+
+    maybe_save_snapshot();
+  }
+
+  // Final snapshot on shutdown so a restart resumes from the freshest
+  // state rather than the last periodic capture
+  if (!config_.persistence.snapshot_path.empty()) {
+    GraphSnapshot::save(config_.persistence.snapshot_path,
+                      price_graph_.writer_view(),
+                        symbols_,
+                        sequence_counter_.load(std::memory_order_relaxed));
+  }
+}
+
+void ArbitrageEngine::maybe_save_snapshot() {
+  if (config_.persistence.snapshot_path.empty()) {
+    return;
+  }
+  uint64_t now_ns = monotonic_ns();
+  uint64_t interval_ns =
+      static_cast<uint64_t>(config_.persistence.snapshot_interval_s) *
+      1000000000ULL;
+  if (now_ns - last_snapshot_ns_ < interval_ns) {
+    return;
   }
+  last_snapshot_ns_ = now_ns;
+  // Running on the processing thread - the only graph writer - so the
+  // serialized view is consistent without any locking
+  GraphSnapshot::save(config_.persistence.snapshot_path,
+                      price_graph_.writer_view(),
+                      symbols_,
+                      sequence_counter_.load(std::memory_order_relaxed));
 }
 
-void ArbitrageEngine::update_price_graph(const MarketTick &tick) {
+void ArbitrageEngine::coalesce_into_batch(const MarketTick *ticks, size_t n,
+                                          TickBatch &batch) {
+  // During bursts the queue holds several updates for the same pair, and
+  // only the newest (by sequence) is worth applying - the graph edge would
+  // be overwritten by the very next tick anyway. Linear key scan is fine at
+  // this batch size and avoids any per-batch allocation.
+  batch.count = 0;
+  for (size_t i = 0; i < n; ++i) {
+    size_t j = 0;
+    for (; j < batch.count; ++j) {
+      if (batch.base_id[j] == ticks[i].base_id &&
+          batch.quote_id[j] == ticks[i].quote_id) {
+        break;
+      }
+    }
+
+    if (j == batch.count) {
+      if (batch.count == TickBatch::CAPACITY) {
+        continue; // cannot happen while drain size == CAPACITY
+      }
+      ++batch.count;
+    } else if (ticks[i].sequence <= batch.sequence[j]) {
+      continue; // older than what the batch already holds
+    }
+
+    batch.base_id[j] = ticks[i].base_id;
+    batch.quote_id[j] = ticks[i].quote_id;
+    batch.pair_id[j] = ticks[i].pair_id;
+    batch.bid[j] = ticks[i].bid;
+    batch.ask[j] = ticks[i].ask;
+    batch.volume[j] = ticks[i].volume;
+    batch.sequence[j] = ticks[i].sequence;
+    batch.timestamp_ns[j] = ticks[i].timestamp_ns;
+    batch.exchange[j] =
+        static_cast<uint8_t>(exchange_shard(ticks[i].exchange));
+  }
+}
+
+void ArbitrageEngine::apply_batch(const TickBatch &batch) {
+  uint64_t newest_ns = last_update_time_ns_.load(std::memory_order_relaxed);
+  uint64_t oldest_ns = UINT64_MAX;
+  for (size_t i = 0; i < batch.count; ++i) {
+    update_price_graph(batch.base_id[i], batch.quote_id[i], batch.pair_id[i],
+                       batch.bid[i], batch.ask[i], batch.exchange[i]);
+    if (batch.timestamp_ns[i] > newest_ns) {
+      newest_ns = batch.timestamp_ns[i];
+    }
+    if (batch.timestamp_ns[i] < oldest_ns) {
+      oldest_ns = batch.timestamp_ns[i];
+    }
+  }
+  last_update_time_ns_.store(newest_ns, std::memory_order_release);
+  if (batch.count > 0) {
+    last_batch_oldest_ns_.store(oldest_ns, std::memory_order_release);
+  }
+
+  // One epoch flip per batch: the detector picks up every edge from this
+  // batch at once on its next pass
+  price_graph_.publish();
+}
+
+void ArbitrageEngine::update_price_graph(uint16_t base_id, uint16_t quote_id,
+                                         uint16_t pair_id, Price bid,
+                                         Price ask, uint8_t shard) {
   // Update the price graph with new market data
   // This implements a simplified currency graph where each trading pair
   // represents an edge in the graph
 
-  auto symbol_pair = parse_symbol(tick.symbol);
-  if (!symbol_pair.has_value())
+  // Ids were resolved at enqueue time; nothing here allocates or hashes
+  size_t base_idx = base_id;
+  size_t quote_idx = quote_id;
+
+  if (base_idx == INVALID_CURRENCY_ID || quote_idx == INVALID_CURRENCY_ID ||
+      base_idx >= price_graph_.capacity() ||
+      quote_idx >= price_graph_.capacity()) {
     return;
+  }
 
-  auto [base, quote] = symbol_pair.value();
+  // Update graph edges; stamped with wall-clock time so snapshots can
+  // age out edges that were already stale when saved. The shard's taker
+  // fee is priced in as an additive log penalty, so every cycle the
+  // detector reports is already net of fees.
+  uint64_t now_ns = wall_clock_ns();
+  double fee_penalty = fee_log_penalty_[shard];
 
-  // Get indices for base and quote currencies
-  size_t base_idx =
-      get_currency_index(base, static_cast<uint8_t>(tick.exchange));
-  size_t quote_idx =
-      get_currency_index(quote, static_cast<uint8_t>(tick.exchange));
+  // Prices snap to the exact FixedPrice grid before weighting, so equal
+  // quotes give bit-identical weights however they were parsed, and
+  // fast_log replaces the two libm calls this path used to make per tick
+  // (see price_math.h)
+  FixedPrice qbid = FixedPrice::from_double(bid);
+  FixedPrice qask = FixedPrice::from_double(ask);
 
-  if (base_idx >= price_graph_.size() || quote_idx >= price_graph_.size()) {
-    return;
+  // Forward edge: base -> quote (selling base for quote)
+  if (qbid.positive()) {
+    price_graph_.upsert_edge(base_idx, quote_idx,
+                             -fast_log(qbid.to_double()) + fee_penalty,
+                             now_ns);
   }
 
-  // Update graph edges
-  // Forward edge: base -> quote (selling base for quote)
-  if (tick.bid > 0) {
-    price_graph_[base_idx][quote_idx] = -std::log(tick.bid);
+  // Reverse edge: quote -> base (buying base with quote); the weight is
+  // +log(ask) directly - the old -log(1/ask) spent a division to say the
+  // same thing
+  if (qask.positive()) {
+    price_graph_.upsert_edge(quote_idx, base_idx,
+                             fast_log(qask.to_double()) + fee_penalty,
+                             now_ns);
+  }
+
+  // Any negative cycle created by these edges passes through their
+  // endpoints, so flagging both is enough for the incremental detector.
+  mark_vertex_dirty(base_idx);
+  mark_vertex_dirty(quote_idx);
+
+  // Same-pair spread check across exchanges: two-leg opportunities decay
+  // faster than a detection interval, so they alert straight from here
+  // instead of waiting for the cycle search. Only the dedicated shards
+  // participate: for them shard index == Exchange, which the emit path
+  // relies on, while the catch-all shard can mix several venues in one
+  // quote slot (see cross_exchange_scanner.h).
+  if (config_.arbitrage.enable_cross_exchange &&
+      pair_id != INVALID_CURRENCY_ID && shard < NUM_EXCHANGE_SHARDS - 1) {
+    CrossExchangeScanner::Spread spread;
+    if (cross_scanner_.on_quote(pair_id, shard, bid, ask, base_id, quote_id,
+                                monotonic_ns(), spread)) {
+      emit_cross_exchange(spread);
+    }
+  }
+}
+
+void ArbitrageEngine::emit_cross_exchange(
+    const CrossExchangeScanner::Spread &spread) {
+  ArbitrageOpportunity opp;
+  // Valid because only dedicated shards feed the scanner, and for those
+  // the shard index is the Exchange value (see exchange_shard())
+  opp.exchange1 = static_cast<Exchange>(spread.buy_shard);
+  opp.exchange2 = static_cast<Exchange>(spread.sell_shard);
+  opp.entry_price = spread.buy_ask;
+  opp.exit_price = spread.sell_bid;
+  opp.profit_percentage = spread.profit;
+  opp.detected_at = std::chrono::high_resolution_clock::now();
+
+  // Quote -> base on the buy venue, base -> quote on the sell venue; the
+  // transfer between venues is the implicit middle hop
+  opp.path = get_currency_name(spread.buy_quote_id) + " -> " +
+             get_currency_name(spread.buy_base_id) + " -> " +
+             get_currency_name(spread.sell_base_id) + " -> " +
+             get_currency_name(spread.sell_quote_id);
+
+  // Executable size: bounded by the asks being lifted on the buy venue
+  // and the bids being hit on the sell venue, in base units
+  double max_base = config_.arbitrage.max_position_size;
+  DepthUpdate book;
+  if (order_books_.snapshot(spread.buy_base_id, spread.buy_quote_id, book) &&
+      book.ask_count > 0) {
+    double depth = 0.0;
+    for (uint8_t l = 0; l < book.ask_count; ++l) {
+      depth += book.asks[l].volume;
+    }
+    max_base = std::min(max_base, depth);
+  }
+  if (order_books_.snapshot(spread.sell_base_id, spread.sell_quote_id, book) &&
+      book.bid_count > 0) {
+    double depth = 0.0;
+    for (uint8_t l = 0; l < book.bid_count; ++l) {
+      depth += book.bids[l].volume;
+    }
+    max_base = std::min(max_base, depth);
+  }
+  opp.max_volume = max_base;
+
+  // Two legs and data fresh by construction - only the profit magnitude
+  // varies the score
+  std::vector<int> path_vertices{static_cast<int>(spread.buy_base_id),
+                                 static_cast<int>(spread.sell_base_id)};
+  opp.confidence =
+      calculate_confidence(path_vertices, std::log1p(spread.profit), 0);
+
+  stats_.cross_exchange_alerts.fetch_add(1, std::memory_order_relaxed);
+  stats_.opportunities_found.fetch_add(1);
+  on_opportunity_detected(opp);
+}
+
+void ArbitrageEngine::mark_vertex_dirty(size_t v) {
+  if (v < dirty_vertices_.size() &&
+      dirty_vertices_[v].exchange(1, std::memory_order_relaxed) == 0) {
+    dirty_count_.fetch_add(1, std::memory_order_release);
+  }
+}
+
+std::vector<size_t> ArbitrageEngine::drain_dirty_vertices() {
+  std::vector<size_t> sources;
+  if (dirty_count_.load(std::memory_order_acquire) == 0) {
+    return sources;
   }
 
-  // Reverse edge: quote -> base (buying base with quote)
-  if (tick.ask > 0) {
-    price_graph_[quote_idx][base_idx] = -std::log(1.0 / tick.ask);
+  // Scan the full flag array rather than a graph vertex count - the
+  // writer owns the graph buffers, and the flags are what matter here
+  const size_t V = dirty_vertices_.size();
+  sources.reserve(64);
+  for (size_t v = 0; v < V; ++v) {
+    if (dirty_vertices_[v].exchange(0, std::memory_order_relaxed) != 0) {
+      dirty_count_.fetch_sub(1, std::memory_order_relaxed);
+      sources.push_back(v);
+    }
   }
+  return sources;
 }
 
 void ArbitrageEngine::detect_arbitrage_opportunities() {
@@ -144,8 +610,42 @@ void ArbitrageEngine::detect_arbitrage_opportunities() {
   while (running_.load()) {
     auto start_time = std::chrono::high_resolution_clock::now();
 
-    // Run Bellman-Ford algorithm to detect negative cycles (arbitrage)
-    auto opportunities = find_negative_cycles();
+    // Run Bellman-Ford algorithm to detect negative cycles (arbitrage).
+    // In incremental mode only vertices touched since the last pass are used
+    // as sources; a full scan runs on a configurable interval as a safety
+    // net against anything the dirty tracking might miss.
+    std::vector<ArbitrageOpportunity> opportunities;
+    bool full_scan_due =
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            start_time - last_full_scan_)
+            .count() >=
+        static_cast<int64_t>(config_.arbitrage.full_scan_interval_ms);
+
+    // Edges older than the TTL are expired lazily inside the detectors -
+    // nothing rewrites the graph, the scan just pretends they are absent
+    uint64_t min_updated_ns = 0;
+    if (config_.arbitrage.edge_ttl_ms > 0) {
+      uint64_t ttl_ns =
+          static_cast<uint64_t>(config_.arbitrage.edge_ttl_ms) * 1000000ULL;
+      uint64_t now_wall_ns = wall_clock_ns(); // edge stamps are wall clock
+      min_updated_ns = now_wall_ns > ttl_ns ? now_wall_ns - ttl_ns : 0;
+    }
+
+    // Pin the published graph buffer for the whole pass; the writer keeps
+    // applying batches to its own buffer meanwhile
+    const SparsePriceGraph &graph = price_graph_.acquire_read();
+    if (!config_.arbitrage.enable_incremental_detection || full_scan_due) {
+      drain_dirty_vertices(); // full pass covers everything; reset the flags
+      opportunities = find_negative_cycles(graph, min_updated_ns);
+      last_full_scan_ = start_time;
+    } else {
+      auto sources = drain_dirty_vertices();
+      if (!sources.empty()) {
+        opportunities =
+            find_negative_cycles_from(graph, sources, min_updated_ns);
+      }
+    }
+    price_graph_.release_read();
 
     // Process found opportunities
     for (const auto &opp : opportunities) {
@@ -159,6 +659,11 @@ void ArbitrageEngine::detect_arbitrage_opportunities() {
     auto detection_latency =
         std::chrono::duration_cast<std::chrono::microseconds>(end_time -
                                                               start_time);
+    stats_.record_stage(
+        STAGE_DETECTION_PASS,
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end_time -
+                                                             start_time)
+            .count());
 
     // Maintain detection frequency
     if (detection_latency < detection_interval) {
@@ -167,63 +672,39 @@ void ArbitrageEngine::detect_arbitrage_opportunities() {
   }
 }
 
-std::vector<ArbitrageOpportunity> ArbitrageEngine::find_negative_cycles() {
-  std::vector<ArbitrageOpportunity> opportunities;
-  const size_t V = price_graph_.size();
-
-  // Bellman-Ford algorithm for shortest paths
-  std::vector<double> dist(V, std::numeric_limits<double>::infinity());
-  std::vector<int> parent(V, -1);
-
-  // Try each vertex as source to find all negative cycles
-  for (size_t src = 0; src < V; ++src) {
-    if (price_graph_[src][src] != 0.0)
-      continue; // Skip inactive currencies
-
-    std::fill(dist.begin(), dist.end(),
-              std::numeric_limits<double>::infinity());
-    std::fill(parent.begin(), parent.end(), -1);
-    dist[src] = 0.0;
-
-    // Relax edges V-1 times
-    for (size_t i = 0; i < V - 1; ++i) {
-      bool updated = false;
-      for (size_t u = 0; u < V; ++u) {
-        if (dist[u] == std::numeric_limits<double>::infinity())
-          continue;
-
-        for (size_t v = 0; v < V; ++v) {
-          if (price_graph_[u][v] != std::numeric_limits<double>::infinity()) {
-            double new_dist = dist[u] + price_graph_[u][v];
-            if (new_dist < dist[v]) {
-              dist[v] = new_dist;
-              parent[v] = static_cast<int>(u);
-              updated = true;
-            }
-          }
-        }
-      }
-      if (!updated)
-        break; // Early termination if no updates
+std::vector<ArbitrageOpportunity>
+ArbitrageEngine::find_negative_cycles(const SparsePriceGraph &graph,
+                                      uint64_t min_updated_ns) {
+  // Full pass: every active vertex is a source
+  std::vector<size_t> sources;
+  const size_t V = graph.vertex_count();
+  sources.reserve(V);
+  for (size_t v = 0; v < V; ++v) {
+    if (graph.is_active(v)) {
+      sources.push_back(v);
     }
+  }
+  return find_negative_cycles_from(graph, sources, min_updated_ns);
+}
 
-    // Check for negative cycles
-    for (size_t u = 0; u < V; ++u) {
-      if (dist[u] == std::numeric_limits<double>::infinity())
-        continue;
-
-      for (size_t v = 0; v < V; ++v) {
-        if (price_graph_[u][v] != std::numeric_limits<double>::infinity()) {
-          if (dist[u] + price_graph_[u][v] < dist[v]) {
-            // Found negative cycle - extract the opportunity
-            auto opp =
-                extract_arbitrage_cycle(static_cast<int>(v), parent, dist);
-            if (opp.has_value()) {
-              opportunities.push_back(opp.value());
-            }
-          }
-        }
-      }
+std::vector<ArbitrageOpportunity> ArbitrageEngine::find_negative_cycles_from(
+    const SparsePriceGraph &graph, const std::vector<size_t> &sources,
+    uint64_t min_updated_ns) {
+  std::vector<ArbitrageOpportunity> opportunities;
+
+  // Shard the search across the detection pool, then turn raw vertex
+  // cycles into scored opportunities. The dedup cache drops cycles that
+  // already alerted within the TTL before any scoring work happens.
+  auto cycles = detection_pool_.find_cycles(graph, sources, min_updated_ns);
+  uint64_t now_ns = monotonic_ns();
+  for (const auto &cycle : cycles) {
+    if (!opportunity_dedup_.should_alert(cycle, now_ns)) {
+      stats_.opportunities_deduped.fetch_add(1, std::memory_order_relaxed);
+      continue;
+    }
+    auto opp = build_opportunity(graph, cycle);
+    if (opp.has_value()) {
+      opportunities.push_back(std::move(opp.value()));
     }
   }
 
@@ -231,40 +712,25 @@ std::vector<ArbitrageOpportunity> ArbitrageEngine::find_negative_cycles() {
 }
 
 std::optional<ArbitrageOpportunity>
-ArbitrageEngine::extract_arbitrage_cycle(int cycle_node,
-                                         const std::vector<int> &parent,
-                                         const std::vector<double> &dist) {
-
-  // Trace back to find the cycle
-  std::vector<int> cycle;
-  std::unordered_set<int> visited;
-
-  int current = cycle_node;
-  while (current != -1 && visited.find(current) == visited.end()) {
-    visited.insert(current);
-    cycle.push_back(current);
-    current = parent[current];
-  }
-
-  if (current == -1 || cycle.size() < 3) {
+ArbitrageEngine::build_opportunity(const SparsePriceGraph &graph,
+                                   const Cycle &arbitrage_path) {
+  if (arbitrage_path.size() < 2) {
     return std::nullopt; // Invalid cycle
   }
 
-  // Find where cycle starts
-  auto cycle_start = std::find(cycle.begin(), cycle.end(), current);
-  if (cycle_start == cycle.end()) {
-    return std::nullopt;
-  }
-
-  // Extract the actual cycle
-  std::vector<int> arbitrage_path(cycle_start, cycle.end());
-  std::reverse(arbitrage_path.begin(), arbitrage_path.end());
-
-  // Calculate profit
+  // Calculate profit; track the oldest edge on the way so confidence can
+  // score the cycle by its true worst-case quote age
   double total_log_return = 0.0;
+  uint64_t oldest_edge_ns = UINT64_MAX;
   for (size_t i = 0; i < arbitrage_path.size(); ++i) {
     size_t next_i = (i + 1) % arbitrage_path.size();
-    total_log_return += price_graph_[arbitrage_path[i]][arbitrage_path[next_i]];
+    total_log_return +=
+        graph.weight(arbitrage_path[i], arbitrage_path[next_i]);
+    uint64_t edge_ns =
+        graph.edge_updated_ns(arbitrage_path[i], arbitrage_path[next_i]);
+    if (edge_ns < oldest_edge_ns) {
+      oldest_edge_ns = edge_ns;
+    }
   }
 
   double profit_multiplier = std::exp(-total_log_return);
@@ -275,11 +741,20 @@ ArbitrageEngine::extract_arbitrage_cycle(int cycle_node,
   }
 
   // Build opportunity description
+  uint64_t now_wall_ns = wall_clock_ns();
+  uint64_t max_edge_age_ms =
+      oldest_edge_ns < now_wall_ns ? (now_wall_ns - oldest_edge_ns) / 1000000
+                                   : 0;
+
   ArbitrageOpportunity opp;
   opp.profit_percentage = profit_percentage;
   opp.detected_at = std::chrono::high_resolution_clock::now();
-  opp.confidence = calculate_confidence(arbitrage_path, total_log_return);
+  opp.confidence =
+      calculate_confidence(arbitrage_path, total_log_return, max_edge_age_ms);
   opp.max_volume = estimate_max_volume(arbitrage_path);
+  if (opp.max_volume <= 0.0) {
+    return std::nullopt; // no executable size at any hop: not an alert
+  }
 
   // Build path string
   std::string path_str;
@@ -294,20 +769,19 @@ ArbitrageEngine::extract_arbitrage_cycle(int cycle_node,
 }
 
 uint32_t ArbitrageEngine::calculate_confidence(const std::vector<int> &path,
-                                               double log_return) const {
+                                               double log_return,
+                                               uint64_t max_edge_age_ms) const {
   // Confidence based on:
   // 1. Magnitude of profit (higher = more confident)
   // 2. Path length (shorter = more confident)
-  // 3. Data freshness (newer = more confident)
+  // 3. Quote freshness: the age of the *oldest* edge in this cycle, not
+  //    the engine-wide last update - one live feed must not vouch for a
+  //    cycle whose other legs went quiet
 
   double profit_confidence = std::min(std::abs(log_return) * 100.0, 50.0);
   double path_confidence = std::max(0.0, 50.0 - path.size() * 10.0);
-
-  auto now = std::chrono::high_resolution_clock::now();
-  auto data_age = std::chrono::duration_cast<std::chrono::milliseconds>(
-                      now - last_update_time_.load())
-                      .count();
-  double freshness_confidence = std::max(0.0, 50.0 - data_age / 100.0);
+  double freshness_confidence =
+      std::max(0.0, 50.0 - static_cast<double>(max_edge_age_ms) / 100.0);
 
   return static_cast<uint32_t>(profit_confidence + path_confidence +
                                freshness_confidence);
@@ -315,44 +789,86 @@ uint32_t ArbitrageEngine::calculate_confidence(const std::vector<int> &path,
 
 Volume
 ArbitrageEngine::estimate_max_volume(const std::vector<int> &path) const {
-  // Simplified volume estimation - in practice this would consider
-  // order book depth and liquidity at each step
-  return config_.arbitrage.max_position_size / path.size();
-}
-
-std::optional<std::pair<std::string, std::string>>
-ArbitrageEngine::parse_symbol(const std::string &symbol) {
-  // Parse trading pairs like "BTC/USDT", "ETH/BTC", etc.
-  auto pos = symbol.find('/');
-  if (pos == std::string::npos || pos == 0 || pos == symbol.length() - 1) {
-    return std::nullopt;
+  // Walk the cycle through the order books: each hop's executable volume
+  // is bounded by the depth on the side being consumed, and the running
+  // bound is converted back into units of the cycle's start currency via
+  // the average fill rate of the preceding hops.
+  double max_start = config_.arbitrage.max_position_size;
+  double scale = 1.0; // start-currency units -> current hop currency units
+
+  for (size_t i = 0; i < path.size(); ++i) {
+    uint16_t u = static_cast<uint16_t>(path[i]);
+    uint16_t v = static_cast<uint16_t>(path[(i + 1) % path.size()]);
+
+    DepthUpdate book;
+    if (order_books_.snapshot(u, v, book) && book.bid_count > 0) {
+      // Selling u (base of pair u/v) into the bids
+      double cap_u = 0.0, proceeds_v = 0.0;
+      for (uint8_t l = 0; l < book.bid_count; ++l) {
+        cap_u += book.bids[l].volume;
+        proceeds_v += book.bids[l].volume * book.bids[l].price;
+      }
+      if (cap_u <= 0.0) {
+        return 0.0; // book exists but is empty: untradeable hop
+      }
+      max_start = std::min(max_start, cap_u / scale);
+      scale *= proceeds_v / cap_u;
+    } else if (order_books_.snapshot(v, u, book) && book.ask_count > 0) {
+      // Buying v (base of pair v/u) from the asks, spending u
+      double cap_v = 0.0, cost_u = 0.0;
+      for (uint8_t l = 0; l < book.ask_count; ++l) {
+        cap_v += book.asks[l].volume;
+        cost_u += book.asks[l].volume * book.asks[l].price;
+      }
+      if (cost_u <= 0.0) {
+        return 0.0;
+      }
+      max_start = std::min(max_start, cost_u / scale);
+      scale *= cap_v / cost_u;
+    } else {
+      // No depth seen for this hop yet: fall back to the conservative
+      // per-hop share the engine used before depth ingestion existed
+      max_start = std::min(max_start,
+                           config_.arbitrage.max_position_size /
+                               static_cast<double>(path.size()));
+    }
   }
 
-  return std::make_pair(symbol.substr(0, pos), symbol.substr(pos + 1));
+  return max_start;
 }
 
-size_t ArbitrageEngine::get_currency_index(const std::string &currency,
-                                           uint8_t exchange) {
-  // Create unique index for each currency on each exchange
-  // In practice, this would use a hash table for O(1) lookup
-  std::string key = currency + "_" + std::to_string(exchange);
+bool ArbitrageEngine::resolve_symbol_ids(MarketTick &tick) {
+  // Split trading pairs like "BTC/USDT" in place and intern both sides -
+  // no substr, no temporary strings
+  const char *slash =
+      static_cast<const char *>(std::memchr(tick.symbol, '/', sizeof(tick.symbol)));
+  if (slash == nullptr || slash == tick.symbol) {
+    return false;
+  }
 
-  auto it = currency_indices_.find(key);
-  if (it != currency_indices_.end()) {
-    return it->second;
+  size_t base_len = static_cast<size_t>(slash - tick.symbol);
+  const char *quote = slash + 1;
+  size_t quote_len = strnlen(quote, sizeof(tick.symbol) - base_len - 1);
+  if (quote_len == 0) {
+    return false;
   }
 
-  // Assign new index
-  size_t index = currency_indices_.size();
-  currency_indices_[key] = index;
-  currency_names_[index] = key;
+  uint8_t exchange = static_cast<uint8_t>(tick.exchange);
+  tick.base_id = symbols_.intern(tick.symbol, base_len, exchange);
+  tick.quote_id = symbols_.intern(quote, quote_len, exchange);
+
+  // The whole pair name is also interned exchange-independently so the
+  // cross-exchange scanner can match quotes for the same pair across
+  // venues. Too-long names just opt the tick out of the fast path.
+  tick.pair_id = symbols_.intern(tick.symbol, base_len + 1 + quote_len,
+                                 PAIR_SYMBOL_NAMESPACE);
 
-  return index;
+  return tick.base_id != INVALID_CURRENCY_ID &&
+         tick.quote_id != INVALID_CURRENCY_ID;
 }
 
 std::string ArbitrageEngine::get_currency_name(size_t index) const {
-  auto it = currency_names_.find(index);
-  return (it != currency_names_.end()) ? it->second : "UNKNOWN";
+  return symbols_.name(static_cast<CurrencyId>(index));
 }
 
 void ArbitrageEngine::register_opportunity_callback(
@@ -361,34 +877,38 @@ void ArbitrageEngine::register_opportunity_callback(
   callbacks_.push_back(std::move(callback));
 }
 
+void ArbitrageEngine::set_tick_journal(JournalWriter *journal) {
+  tick_journal_ = journal;
+}
+
 void ArbitrageEngine::on_opportunity_detected(
     const ArbitrageOpportunity &opportunity) {
-  // Rate limiting
-  auto now = std::chrono::high_resolution_clock::now();
-  static auto last_alert = now;
-  static uint32_t alerts_this_second = 0;
-
-  if (std::chrono::duration_cast<std::chrono::seconds>(now - last_alert)
-          .count() >= 1) {
-    alerts_this_second = 0;
-    last_alert = now;
+  // Rate limiting. Both the detection thread and the processing thread's
+  // cross-exchange fast path emit through here, so the per-second window
+  // lives in atomics rather than the old function-local statics.
+  uint64_t now_s = monotonic_ns() / 1000000000ULL;
+  uint64_t window = alert_window_s_.load(std::memory_order_relaxed);
+  if (now_s != window &&
+      alert_window_s_.compare_exchange_strong(window, now_s,
+                                              std::memory_order_relaxed)) {
+    alerts_in_window_.store(0, std::memory_order_relaxed);
   }
 
-  if (alerts_this_second >= config_.arbitrage.max_opportunities_per_second) {
+  if (alerts_in_window_.fetch_add(1, std::memory_order_relaxed) >=
+      config_.arbitrage.max_opportunities_per_second) {
     return; // Rate limited
   }
 
-  alerts_this_second++;
-
-  // Store opportunity
-  {
-    std::lock_guard<std::mutex> lock(opportunities_mutex_);
-    detected_opportunities_.push_back(opportunity);
+  // Store opportunity; old entries are overwritten in ring order, readers
+  // never block the detector
+  opportunity_ring_.push(opportunity);
 
-    // Keep only recent opportunities (last 1000)
-    if (detected_opportunities_.size() > 1000) {
-      detected_opportunities_.erase(detected_opportunities_.begin());
-    }
+  // True pipeline latency: tick ingress to alert emission, anchored at the
+  // oldest tick of the batch that produced the current graph state
+  uint64_t anchor_ns = last_batch_oldest_ns_.load(std::memory_order_acquire);
+  uint64_t alert_ns = monotonic_ns();
+  if (anchor_ns != 0 && alert_ns > anchor_ns) {
+    stats_.record_stage(STAGE_TICK_TO_ALERT, alert_ns - anchor_ns);
   }
 
   // Notify callbacks
@@ -402,24 +922,27 @@ void ArbitrageEngine::on_opportunity_detected(
         std::cerr << "Error in opportunity callback: " << e.what() << std::endl;
       }
     }
+    stats_.record_stage(STAGE_CALLBACK, monotonic_ns() - alert_ns);
   }
 }
 
 std::vector<ArbitrageOpportunity>
 ArbitrageEngine::get_recent_opportunities(size_t limit) const {
-  std::lock_guard<std::mutex> lock(opportunities_mutex_);
-
-  size_t start_idx = detected_opportunities_.size() > limit
-                         ? detected_opportunities_.size() - limit
-                         : 0;
+  return opportunity_ring_.snapshot(limit);
+}
 
-  return std::vector<ArbitrageOpportunity>(detected_opportunities_.begin() +
-                                               start_idx,
-                                           detected_opportunities_.end());
+uint64_t ArbitrageEngine::opportunity_generation() const {
+  return opportunity_ring_.generation();
 }
 
-PerformanceStats ArbitrageEngine::get_performance_stats() const {
-  return stats_;
+PerformanceStats::Snapshot ArbitrageEngine::get_performance_stats() const {
+  PerformanceStats::Snapshot s = stats_.snapshot();
+  for (size_t i = 0; i < tick_queues_.size(); ++i) {
+    s.queue_depth[i] = tick_queues_[i]->size_approx();
+  }
+  s.graph_edges = price_graph_.edge_count_approx();
+  s.graph_vertices = price_graph_.vertex_count_approx();
+  return s;
 }
 
 } // namespace arbitrage
\ No newline at end of file
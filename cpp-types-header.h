@@ -1,10 +1,15 @@
 // types.h - Core data types and structures
 #pragma once
 
+#include "fee_model.h"
+#include "latency_histogram.h"
 #include <atomic>
 #include <chrono>
+#include <cstdint>
+#include <cstring>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 namespace arbitrage {
@@ -13,6 +18,43 @@ using Price = double;
 using Volume = double;
 using Timestamp = std::chrono::high_resolution_clock::time_point;
 
+// Hot-path timestamps are plain nanosecond counts: trivially copyable,
+// atomically storable, and free of time_point template baggage in the tick
+// layout. steady_clock specifically - high_resolution_clock is an alias of
+// system_clock on libstdc++, which is not steady, and every consumer here
+// (stage latency deltas, replay pacing) assumes time never steps backward.
+inline uint64_t monotonic_ns() {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+}
+
+// Wall-clock counterpart for values that must survive a restart (e.g.
+// snapshot edge timestamps); monotonic_ns() has no meaning across
+// processes.
+inline uint64_t wall_clock_ns() {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::system_clock::now().time_since_epoch())
+          .count());
+}
+
+// Negative-cycle detection backends (see cycle_detector.h)
+enum class DetectorAlgorithm : uint8_t {
+  BELLMAN_FORD = 0,
+  SPFA = 1,
+  HOP_LIMITED = 2 // bounded k<=3 / k<=4 enumeration (triangular arbitrage)
+};
+
+// Consumer idle behavior for the processing thread (see
+// ArbitrageEngine::process_market_data)
+enum class WaitStrategy : uint8_t {
+  SLEEP = 0,    // fixed 100μs sleep (legacy behavior)
+  BUSY_SPIN = 1, // never yield the core; lowest latency, burns a full CPU
+  HYBRID = 2     // spin, then yield, then park with producer wakeup
+};
+
 // Exchange identifiers
 enum class Exchange : uint8_t {
   BINANCE = 0,
@@ -21,23 +63,59 @@ enum class Exchange : uint8_t {
   UNKNOWN = 255
 };
 
-// Market data structure optimized for cache efficiency
-struct MarketTick {
-  Exchange exchange;
-  char symbol[16]; // e.g., "BTC/USDT"
-  Price bid;
-  Price ask;
-  Price last_price;
-  Volume volume;
-  Timestamp timestamp;
-  uint64_t sequence; // For ordering
-
-  MarketTick()
-      : exchange(Exchange::UNKNOWN), bid(0), ask(0), last_price(0), volume(0),
-        sequence(0) {
-    std::memset(symbol, 0, sizeof(symbol));
-    timestamp = std::chrono::high_resolution_clock::now();
-  }
+// Ingestion queue shards: one per real exchange feed thread plus a
+// catch-all for anything else (see exchange_shard()). Each shard is a
+// single-producer ring, so every exchange feed must stay on its own
+// thread.
+const size_t NUM_EXCHANGE_SHARDS = 4;
+
+inline size_t exchange_shard(Exchange exchange) {
+  size_t idx = static_cast<uint8_t>(exchange);
+  return idx < NUM_EXCHANGE_SHARDS - 1 ? idx : NUM_EXCHANGE_SHARDS - 1;
+}
+
+// Market data structure: exactly one cache line, trivially copyable so the
+// SPSC ring and the tick journal can move it with plain memcpy semantics.
+// No constructor work - the old default constructor even called
+// clock::now(), pure overhead on the hot path. Producers value-initialize
+// (MarketTick tick{};) and fill fields explicitly.
+struct alignas(64) MarketTick {
+  Price bid;             // 8
+  Price ask;             // 8
+  Volume volume;         // 8
+  uint64_t timestamp_ns; // 8  monotonic_ns() at enqueue
+  uint64_t sequence;     // 8  for ordering / coalescing
+  char symbol[16];       // e.g., "BTC/USDT"
+  uint16_t base_id;      // interned CurrencyId, resolved at enqueue time
+  uint16_t quote_id;     // (see symbol_table.h); 0xFFFF = unresolved
+  uint16_t pair_id;      // exchange-independent pair id (cross-exchange scan)
+  Exchange exchange;     // 1 (+1 byte pad to 64)
+
+  Price mid_price() const { return (bid + ask) / 2.0; }
+};
+
+static_assert(sizeof(MarketTick) == 64, "MarketTick must be one cache line");
+static_assert(std::is_trivially_copyable<MarketTick>::value,
+              "MarketTick must be trivially copyable");
+
+// Struct-of-arrays view of a coalesced tick batch: the graph-update pass
+// walks one field at a time (all ids, then all prices), so each column is
+// packed and cache-line aligned instead of striding through 64-byte AoS
+// records. Batches are recycled through a MemoryPool rather than allocated
+// per drain.
+struct TickBatch {
+  static const size_t CAPACITY = 256;
+
+  size_t count = 0;
+  alignas(64) uint16_t base_id[CAPACITY];
+  alignas(64) uint16_t quote_id[CAPACITY];
+  alignas(64) uint16_t pair_id[CAPACITY];
+  alignas(64) Price bid[CAPACITY];
+  alignas(64) Price ask[CAPACITY];
+  alignas(64) Volume volume[CAPACITY];
+  alignas(64) uint64_t sequence[CAPACITY];
+  alignas(64) uint64_t timestamp_ns[CAPACITY];
+  alignas(64) uint8_t exchange[CAPACITY]; // shard index for fee lookup
 };
 
 // Arbitrage opportunity structure
@@ -67,20 +145,92 @@ template <typename T> struct QueueNode {
 
 // Thread-safe statistics for performance monitoring
 struct PerformanceStats {
-  std::atomic<uint64_t> messages_processed;
   std::atomic<uint64_t> opportunities_found;
   std::atomic<uint64_t> false_positives;
+  std::atomic<uint64_t> ticks_coalesced; // superseded by newer same-pair ticks
+  std::atomic<uint64_t> opportunities_deduped; // repeat cycles within TTL
+  std::atomic<uint64_t> cross_exchange_alerts; // two-leg fast-path emissions
   std::atomic<double> avg_latency_us;
   std::atomic<Timestamp> last_update;
 
+  // Per-shard ingestion counters, padded to one cache line per shard:
+  // each slot is written by exactly one producer thread (the shard's
+  // feed), so an increment is a relaxed add to a line that core already
+  // owns - no cross-thread traffic on the enqueue path. Nothing reads
+  // these until snapshot()/scrape time, where the per-shard values are
+  // summed into the aggregate counts.
+  struct alignas(64) ShardCounters {
+    std::atomic<uint64_t> ticks_ingested;
+    std::atomic<uint64_t> ticks_dropped; // ring full at enqueue time
+    ShardCounters() : ticks_ingested(0), ticks_dropped(0) {}
+  };
+  ShardCounters shard_counters[NUM_EXCHANGE_SHARDS];
+
   PerformanceStats()
-      : messages_processed(0), opportunities_found(0), false_positives(0),
+      : opportunities_found(0), false_positives(0), ticks_coalesced(0),
+        opportunities_deduped(0), cross_exchange_alerts(0),
         avg_latency_us(0.0) {}
 
+  // Per-stage HDR histograms; record() is lock-free and hot-path safe
+  LatencyHistogram stage_latency[NUM_PIPELINE_STAGES];
+
+  void record_stage(PipelineStage stage, uint64_t ns) {
+    stage_latency[stage].record(ns);
+  }
+
   void update_latency(double latency_us) {
-    // Exponential moving average
+    // Exponential moving average, CAS loop so concurrent updates are not
+    // lost (the old load/store pair raced)
     double current = avg_latency_us.load();
-    avg_latency_us.store(0.9 * current + 0.1 * latency_us);
+    double next;
+    do {
+      next = 0.9 * current + 0.1 * latency_us;
+    } while (!avg_latency_us.compare_exchange_weak(current, next));
+  }
+
+  // Plain-value copy for query APIs - the atomics themselves are not
+  // copyable, so get_performance_stats() hands out one of these.
+  struct Snapshot {
+    uint64_t messages_processed;
+    uint64_t opportunities_found;
+    uint64_t false_positives;
+    uint64_t ticks_coalesced;
+    uint64_t opportunities_deduped;
+    uint64_t cross_exchange_alerts;
+    double avg_latency_us;
+    LatencyHistogram::Snapshot stages[NUM_PIPELINE_STAGES];
+    uint64_t ticks_ingested[NUM_EXCHANGE_SHARDS];
+    uint64_t queue_dropped[NUM_EXCHANGE_SHARDS];
+    // Instantaneous per-shard depth, sampled by get_performance_stats()
+    size_t queue_depth[NUM_EXCHANGE_SHARDS];
+    // Published graph size, sampled by get_performance_stats()
+    size_t graph_edges;
+    size_t graph_vertices;
+  };
+
+  Snapshot snapshot() const {
+    Snapshot s;
+    s.opportunities_found = opportunities_found.load();
+    s.false_positives = false_positives.load();
+    s.ticks_coalesced = ticks_coalesced.load();
+    s.opportunities_deduped = opportunities_deduped.load();
+    s.cross_exchange_alerts = cross_exchange_alerts.load();
+    s.avg_latency_us = avg_latency_us.load();
+    for (size_t i = 0; i < NUM_PIPELINE_STAGES; ++i) {
+      s.stages[i] = stage_latency[i].snapshot();
+    }
+    s.messages_processed = 0;
+    for (size_t i = 0; i < NUM_EXCHANGE_SHARDS; ++i) {
+      s.ticks_ingested[i] =
+          shard_counters[i].ticks_ingested.load(std::memory_order_relaxed);
+      s.queue_dropped[i] =
+          shard_counters[i].ticks_dropped.load(std::memory_order_relaxed);
+      s.messages_processed += s.ticks_ingested[i];
+      s.queue_depth[i] = 0; // owner of the queues fills this in
+    }
+    s.graph_edges = 0; // owner of the graph fills these in
+    s.graph_vertices = 0;
+    return s;
   }
 };
 
@@ -92,6 +242,25 @@ struct Config {
     uint32_t reconnect_interval_ms = 5000;
     uint8_t max_reconnect_attempts = 10;
     bool enable_compression = true;
+
+    // Where each exchange feed handler connects, indexed by Exchange.
+    // The real endpoints are TLS-only, and the feed path deliberately
+    // carries no crypto library dependency (same trade the dashboard
+    // WebSocket server makes), so these default to a local
+    // TLS-terminating proxy (stunnel/haproxy) in front of
+    // stream.binance.com:9443, ws-feed.exchange.coinbase.com and
+    // ws.kraken.com respectively.
+    struct FeedEndpoint {
+      std::string host;
+      uint16_t port = 0;
+      std::string path;
+    };
+    std::vector<FeedEndpoint> feed_endpoints;
+    Network() {
+      feed_endpoints.push_back({"127.0.0.1", 9601, "/ws"});
+      feed_endpoints.push_back({"127.0.0.1", 9602, "/"});
+      feed_endpoints.push_back({"127.0.0.1", 9603, "/"});
+    }
   } network;
 
   struct Threading {
@@ -99,6 +268,9 @@ struct Config {
     uint8_t num_processor_threads = 4;
     bool pin_threads = true;
     uint32_t queue_capacity = 65536;
+    WaitStrategy wait_strategy = WaitStrategy::HYBRID;
+    uint32_t spin_iterations = 2000;  // pause-spins before yielding
+    uint32_t yield_iterations = 100; // yields before parking
     std::vector<uint8_t> cpu_affinity;
     // Constructor to initialize the vector
     Threading() {
@@ -113,8 +285,22 @@ struct Config {
     double min_profit_threshold = 0.001; // 0.1%
     double max_position_size = 1000.0;
     uint32_t max_opportunities_per_second = 100;
+    bool enable_incremental_detection = true;
+    uint32_t full_scan_interval_ms = 1000; // full Bellman-Ford safety net
+    DetectorAlgorithm detector_algorithm = DetectorAlgorithm::BELLMAN_FORD;
+    // When set, detection runs the bounded HOP_LIMITED enumeration instead
+    // of detector_algorithm: cycles longer than max_cycle_length are priced
+    // out by calculate_confidence() anyway, and the bounded search is
+    // microseconds instead of milliseconds per pass
     bool enable_triangle_arbitrage = true;
+    uint32_t max_cycle_length = 3; // hop-limited mode: 3 (triangles) or 4
     bool enable_cross_exchange = true;
+    // Suppress repeat alerts for the same cycle within this window
+    uint32_t dedup_ttl_ms = 500;
+    // Edges not refreshed within this window are skipped by the detectors
+    // as if absent, so a dead feed cannot produce phantom arbitrage
+    // against hours-old prices. 0 disables aging.
+    uint32_t edge_ttl_ms = 5000;
     std::vector<std::string> monitored_symbols;
     // Constructor to initialize the vector
     Arbitrage() {
@@ -125,6 +311,46 @@ struct Config {
     }
   } arbitrage;
 
+  struct Fees {
+    // One schedule per ingestion shard (see fee_model.h). Evaluated once
+    // at engine construction into additive log penalties; edges then
+    // price in the taker fee with a lookup and an add.
+    FeeSchedule schedule[NUM_EXCHANGE_SHARDS];
+
+    Fees() {
+      // Binance: flat 10 bps taker
+      schedule[0].kind = FeeModelKind::FLAT_FEE;
+      schedule[0].taker_fee = 0.001;
+
+      // Coinbase: volume-tiered taker, 60 bps base
+      schedule[1].kind = FeeModelKind::TIERED_FEE;
+      schedule[1].taker_fee = 0.006;
+      schedule[1].tier_count = 3;
+      schedule[1].tier_volume[0] = 10000.0;
+      schedule[1].tier_fee[0] = 0.004;
+      schedule[1].tier_volume[1] = 50000.0;
+      schedule[1].tier_fee[1] = 0.0025;
+      schedule[1].tier_volume[2] = 1000000.0;
+      schedule[1].tier_fee[2] = 0.0015;
+
+      // Kraken: flat 26 bps taker
+      schedule[2].kind = FeeModelKind::FLAT_FEE;
+      schedule[2].taker_fee = 0.0026;
+
+      // Catch-all shard: no fee assumption
+      schedule[3].kind = FeeModelKind::ZERO_FEE;
+    }
+  } fees;
+
+  struct Persistence {
+    // Empty path disables snapshotting entirely
+    std::string snapshot_path;
+    uint32_t snapshot_interval_s = 30;
+    // Edges older than this at restore time are discarded rather than
+    // resurrected as stale prices
+    uint32_t max_edge_age_s = 300;
+  } persistence;
+
   struct Logging {
     std::string level = "INFO";
     std::string file_path = "/var/log/arbitrage.log";
@@ -0,0 +1,138 @@
+// cross_exchange_scanner.h - O(1) two-leg spread check across exchanges
+#pragma once
+
+#include "cpp-types-header.h"
+#include "fee_model.h"
+#include "symbol_table.h"
+#include <cstdint>
+#include <vector>
+
+namespace arbitrage {
+
+// Reserved exchange byte for interning whole pair names ("BTC/USDT")
+// through the SymbolTable: the resulting PairId identifies the pair
+// *across* exchanges, unlike CurrencyId which is per (exchange,
+// currency). Pair names contain '/' so they can never collide with
+// currency codes.
+const uint8_t PAIR_SYMBOL_NAMESPACE = 0xFE;
+
+// The simplest and most frequent opportunity - one exchange bidding a
+// pair above another exchange's ask - only surfaces through the full
+// cycle search, whose 10ms cadence is slower than these spreads live.
+// This scanner keeps the current best bid/ask per pair per ingestion
+// shard and re-checks the spread inline on every quote update: four
+// shards means the check is a constant handful of multiplies, so it
+// rides the graph-update hot path without measurable cost.
+//
+// Owned and driven by the processing thread only; no synchronization.
+// Only the dedicated shards feed the scanner: the catch-all shard would
+// fold several venues into one quote slot (and its shard index does not
+// name a single Exchange), so the engine excludes it - exchanges without
+// a dedicated shard are invisible here, the same trade-off the fee
+// schedule already makes.
+class CrossExchangeScanner {
+public:
+  // A profitable two-leg spread: buy base on buy_shard's ask, sell it on
+  // sell_shard's bid. profit is the round-trip multiplier minus one, net
+  // of both shards' taker fees.
+  struct Spread {
+    size_t buy_shard;
+    size_t sell_shard;
+    Price buy_ask;
+    Price sell_bid;
+    uint16_t buy_base_id, buy_quote_id;   // vertex ids on the buy shard
+    uint16_t sell_base_id, sell_quote_id; // vertex ids on the sell shard
+    double profit;
+  };
+
+  CrossExchangeScanner(size_t pair_capacity, const Config::Fees &fees,
+                       double min_profit, uint32_t alert_ttl_ms)
+      : entries_(pair_capacity), min_profit_(min_profit),
+        alert_ttl_ns_(static_cast<uint64_t>(alert_ttl_ms) * 1000000ULL) {
+    for (size_t i = 0; i < NUM_EXCHANGE_SHARDS; ++i) {
+      net_[i] = 1.0 - resolve_taker_fee(fees.schedule[i]);
+    }
+  }
+
+  // Record a quote for `pair_id` on `shard` and re-check the spread.
+  // Returns true (and fills `out`) when the update opens a cross-shard
+  // spread clearing min_profit that has not alerted within the TTL.
+  bool on_quote(uint16_t pair_id, size_t shard, Price bid, Price ask,
+                uint16_t base_id, uint16_t quote_id, uint64_t now_ns,
+                Spread &out) {
+    if (pair_id >= entries_.size()) {
+      return false;
+    }
+    PairQuotes &pair = entries_[pair_id];
+    Quote &quote = pair.quotes[shard];
+    quote.bid = bid;
+    quote.ask = ask;
+    quote.base_id = base_id;
+    quote.quote_id = quote_id;
+
+    // Best buy/sell pairing across shards: a dozen multiplies, no loop
+    // over pairs or exchanges beyond the fixed shard count
+    double best = 0.0;
+    size_t best_buy = 0, best_sell = 0;
+    for (size_t s = 0; s < NUM_EXCHANGE_SHARDS; ++s) {
+      if (pair.quotes[s].bid <= 0.0) {
+        continue;
+      }
+      double net_bid = pair.quotes[s].bid * net_[s];
+      for (size_t b = 0; b < NUM_EXCHANGE_SHARDS; ++b) {
+        if (b == s || pair.quotes[b].ask <= 0.0) {
+          continue;
+        }
+        double multiplier = net_bid * net_[b] / pair.quotes[b].ask;
+        if (multiplier > best) {
+          best = multiplier;
+          best_buy = b;
+          best_sell = s;
+        }
+      }
+    }
+
+    if (best - 1.0 <= min_profit_) {
+      return false;
+    }
+    if (now_ns - pair.last_alert_ns < alert_ttl_ns_) {
+      ++suppressed_;
+      return false;
+    }
+    pair.last_alert_ns = now_ns;
+
+    out.buy_shard = best_buy;
+    out.sell_shard = best_sell;
+    out.buy_ask = pair.quotes[best_buy].ask;
+    out.sell_bid = pair.quotes[best_sell].bid;
+    out.buy_base_id = pair.quotes[best_buy].base_id;
+    out.buy_quote_id = pair.quotes[best_buy].quote_id;
+    out.sell_base_id = pair.quotes[best_sell].base_id;
+    out.sell_quote_id = pair.quotes[best_sell].quote_id;
+    out.profit = best - 1.0;
+    return true;
+  }
+
+  uint64_t suppressed_count() const { return suppressed_; }
+
+private:
+  struct Quote {
+    Price bid = 0.0;
+    Price ask = 0.0;
+    uint16_t base_id = INVALID_CURRENCY_ID;
+    uint16_t quote_id = INVALID_CURRENCY_ID;
+  };
+
+  struct PairQuotes {
+    Quote quotes[NUM_EXCHANGE_SHARDS];
+    uint64_t last_alert_ns = 0;
+  };
+
+  std::vector<PairQuotes> entries_; // indexed by PairId
+  double net_[NUM_EXCHANGE_SHARDS]; // 1 - taker fee, per shard
+  double min_profit_;
+  uint64_t alert_ttl_ns_;
+  uint64_t suppressed_ = 0;
+};
+
+} // namespace arbitrage
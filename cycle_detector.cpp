@@ -0,0 +1,278 @@
+// cycle_detector.cpp - Negative-cycle detection backend implementations
+#include "cycle_detector.h"
+#include "simd_relax.h"
+#include <algorithm>
+#include <deque>
+#include <limits>
+
+namespace arbitrage {
+
+namespace {
+
+// Recover the cycle containing (or upstream of) `start` from a parent array.
+// The walk stamps each vertex with the current epoch; the first re-stamped
+// vertex is guaranteed to sit on the cycle, so the walk costs O(path length)
+// rather than the V parent hops the naive version needed, and bumping the
+// epoch resets the "visited set" in O(1). Returns an empty cycle if the
+// parent chain is broken.
+Cycle trace_cycle(DetectionScratch &scratch, size_t V, int start) {
+  const uint64_t epoch = ++scratch.current_epoch;
+
+  // Walk until we revisit a vertex: that vertex lies inside the cycle
+  int current = start;
+  while (current >= 0 && scratch.visit_epoch[current] != epoch) {
+    scratch.visit_epoch[current] = epoch;
+    current = scratch.parent[current];
+  }
+  if (current < 0) {
+    return {};
+  }
+
+  Cycle cycle;
+  int walk = current;
+  do {
+    cycle.push_back(walk);
+    walk = scratch.parent[walk];
+    if (walk < 0 || cycle.size() > V) {
+      return {};
+    }
+  } while (walk != current);
+
+  // Parent pointers run backwards along the cycle; reverse into trade order.
+  std::reverse(cycle.begin(), cycle.end());
+  return cycle;
+}
+
+// Compile-time unrolled DFS for the hop-limited detector. HopsLeft is the
+// number of edges still available from `u`; the closing edge back to
+// `start` always costs one, so extending through an intermediate vertex
+// requires HopsLeft > 1. `if constexpr` prunes the recursion at compile
+// time, giving each cycle length its own flat loop nest.
+template <int HopsLeft>
+void extend(const SparsePriceGraph &graph, int start, int u, double weight,
+            uint64_t min_updated_ns, Cycle &path, std::vector<Cycle> &cycles) {
+  const auto &row = graph.row(u);
+  for (size_t e = 0; e < row.size(); ++e) {
+    if (row.updated_ns[e] < min_updated_ns) {
+      continue; // stale edge: feed went quiet, treat as absent
+    }
+    int v = static_cast<int>(row.to[e]);
+    double w = weight + row.weight[e];
+
+    if (v == start) {
+      // Closing edge: a negative sum means the round trip multiplies to
+      // more than 1x. Length-2 cycles are kept - a crossed book is real.
+      if (path.size() >= 2 && w < 0.0) {
+        cycles.push_back(path);
+      }
+      continue;
+    }
+
+    if constexpr (HopsLeft > 1) {
+      // Simple cycles only; the path holds at most three vertices here,
+      // so a linear scan beats any set
+      bool on_path = false;
+      for (int p : path) {
+        if (p == v) {
+          on_path = true;
+          break;
+        }
+      }
+      if (on_path) {
+        continue;
+      }
+      path.push_back(v);
+      extend<HopsLeft - 1>(graph, start, v, w, min_updated_ns, path, cycles);
+      path.pop_back();
+    }
+  }
+}
+
+} // namespace
+
+std::vector<Cycle>
+BellmanFordDetector::find_cycles(const SparsePriceGraph &graph,
+                                 const std::vector<size_t> &sources,
+                                 uint64_t min_updated_ns) {
+  std::vector<Cycle> cycles;
+  const size_t V = graph.vertex_count();
+  if (V == 0 || sources.empty()) {
+    return cycles;
+  }
+
+  scratch_.ensure_capacity(V);
+  auto &dist = scratch_.dist;
+  auto &parent = scratch_.parent;
+
+  for (size_t src : sources) {
+    if (src >= V || !graph.is_active(src)) {
+      continue;
+    }
+
+    std::fill(dist.begin(), dist.begin() + V,
+              std::numeric_limits<double>::infinity());
+    std::fill(parent.begin(), parent.begin() + V, -1);
+    dist[src] = 0.0;
+
+    // Relax live edges V-1 times with early termination. Each row is fed
+    // through the vectorized kernel (AVX2 when the CPU has it).
+    for (size_t i = 0; i < V - 1; ++i) {
+      bool updated = false;
+      for (size_t u = 0; u < V; ++u) {
+        if (dist[u] == std::numeric_limits<double>::infinity()) {
+          continue;
+        }
+        if (simd::relax_row(dist[u], graph.row(u), dist.data(), parent.data(),
+                            static_cast<int>(u), min_updated_ns)) {
+          updated = true;
+        }
+      }
+      if (!updated) {
+        break;
+      }
+    }
+
+    // Any edge still relaxable sits on a path into a negative cycle
+    for (size_t u = 0; u < V; ++u) {
+      if (dist[u] == std::numeric_limits<double>::infinity()) {
+        continue;
+      }
+      const auto &row = graph.row(u);
+      for (size_t e = 0; e < row.size(); ++e) {
+        if (row.updated_ns[e] < min_updated_ns) {
+          continue;
+        }
+        if (dist[u] + row.weight[e] < dist[row.to[e]]) {
+          auto cycle = trace_cycle(scratch_, V, static_cast<int>(row.to[e]));
+          if (!cycle.empty()) {
+            cycles.push_back(std::move(cycle));
+          }
+        }
+      }
+    }
+  }
+
+  return cycles;
+}
+
+std::vector<Cycle>
+SpfaDetector::find_cycles(const SparsePriceGraph &graph,
+                          const std::vector<size_t> &sources,
+                          uint64_t min_updated_ns) {
+  std::vector<Cycle> cycles;
+  const size_t V = graph.vertex_count();
+  if (V == 0 || sources.empty()) {
+    return cycles;
+  }
+
+  scratch_.ensure_capacity(V);
+  auto &dist = scratch_.dist;
+  auto &parent = scratch_.parent;
+  auto &in_queue = scratch_.in_queue;       // bitmap: vertex currently queued
+  auto &relax_count = scratch_.relax_count; // relaxations per vertex
+  auto &queue = scratch_.queue;
+
+  for (size_t src : sources) {
+    if (src >= V || !graph.is_active(src)) {
+      continue;
+    }
+
+    std::fill(dist.begin(), dist.begin() + V,
+              std::numeric_limits<double>::infinity());
+    std::fill(parent.begin(), parent.begin() + V, -1);
+    std::fill(in_queue.begin(), in_queue.begin() + V, 0);
+    std::fill(relax_count.begin(), relax_count.begin() + V, 0);
+    queue.clear();
+
+    dist[src] = 0.0;
+    queue.push_back(static_cast<uint32_t>(src));
+    in_queue[src] = 1;
+
+    bool found_cycle = false;
+    while (!queue.empty() && !found_cycle) {
+      uint32_t u = queue.front();
+      queue.pop_front();
+      in_queue[u] = 0;
+
+      const auto &row = graph.row(u);
+      for (size_t e = 0; e < row.size(); ++e) {
+        if (row.updated_ns[e] < min_updated_ns) {
+          continue; // stale edge: treat as absent
+        }
+        uint32_t v = row.to[e];
+        double new_dist = dist[u] + row.weight[e];
+        if (new_dist < dist[v]) {
+          dist[v] = new_dist;
+          parent[v] = static_cast<int>(u);
+
+          // A vertex relaxed >= V times can only mean a negative cycle
+          if (++relax_count[v] >= V) {
+            auto cycle = trace_cycle(scratch_, V, static_cast<int>(v));
+            if (!cycle.empty()) {
+              cycles.push_back(std::move(cycle));
+            }
+            found_cycle = true;
+            break;
+          }
+
+          if (!in_queue[v]) {
+            // SLF heuristic: promising vertices jump the queue
+            if (!queue.empty() && dist[v] < dist[queue.front()]) {
+              queue.push_front(v);
+            } else {
+              queue.push_back(v);
+            }
+            in_queue[v] = 1;
+          }
+        }
+      }
+    }
+  }
+
+  return cycles;
+}
+
+std::vector<Cycle>
+HopLimitedDetector::find_cycles(const SparsePriceGraph &graph,
+                                const std::vector<size_t> &sources,
+                                uint64_t min_updated_ns) {
+  std::vector<Cycle> cycles;
+  const size_t V = graph.vertex_count();
+  if (V == 0 || sources.empty()) {
+    return cycles;
+  }
+
+  // The same cycle is re-discovered from each of its dirty vertices; the
+  // engine's dedup cache collapses those, so no canonicalization here.
+  for (size_t src : sources) {
+    if (src >= V || !graph.is_active(src)) {
+      continue;
+    }
+    path_.clear();
+    path_.push_back(static_cast<int>(src));
+    if (four_leg_) {
+      extend<4>(graph, static_cast<int>(src), static_cast<int>(src), 0.0,
+                min_updated_ns, path_, cycles);
+    } else {
+      extend<3>(graph, static_cast<int>(src), static_cast<int>(src), 0.0,
+                min_updated_ns, path_, cycles);
+    }
+  }
+
+  return cycles;
+}
+
+std::unique_ptr<CycleDetector> make_cycle_detector(DetectorAlgorithm algorithm,
+                                                   uint32_t max_cycle_length) {
+  switch (algorithm) {
+  case DetectorAlgorithm::SPFA:
+    return std::make_unique<SpfaDetector>();
+  case DetectorAlgorithm::HOP_LIMITED:
+    return std::make_unique<HopLimitedDetector>(max_cycle_length);
+  case DetectorAlgorithm::BELLMAN_FORD:
+  default:
+    return std::make_unique<BellmanFordDetector>();
+  }
+}
+
+} // namespace arbitrage
@@ -0,0 +1,121 @@
+// cycle_detector.h - Pluggable negative-cycle detection backends
+#pragma once
+
+#include "cpp-types-header.h"
+#include "sparse_graph.h"
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace arbitrage {
+
+// A detected cycle as a sequence of vertex indices. The closing edge from
+// the last vertex back to the first is implicit.
+using Cycle = std::vector<int>;
+
+// Reusable scratch buffers for one detector instance. Detection runs at
+// 100Hz and each pass used to allocate fresh dist/parent vectors (~48 KB at
+// full vertex count) plus per-cycle visited sets; the arena is sized once
+// and reused. Each worker in the detection pool owns its own detector and
+// therefore its own scratch, so nothing here needs synchronization. The
+// epoch-stamped visit array replaces per-trace visited sets: bumping the
+// epoch invalidates all stamps in O(1) instead of clearing a structure.
+struct DetectionScratch {
+  std::vector<double> dist;
+  std::vector<int> parent;
+  std::vector<uint8_t> in_queue;      // SPFA: vertex currently queued
+  std::vector<uint32_t> relax_count;  // SPFA: relaxations per vertex
+  std::vector<uint64_t> visit_epoch;  // cycle tracing: visited iff == epoch
+  uint64_t current_epoch = 0;
+  std::deque<uint32_t> queue;
+
+  void ensure_capacity(size_t vertices) {
+    if (dist.size() < vertices) {
+      dist.resize(vertices);
+      parent.resize(vertices);
+      in_queue.resize(vertices);
+      relax_count.resize(vertices);
+      visit_epoch.resize(vertices, 0);
+    }
+  }
+};
+
+// Interface for negative-cycle search over the sparse price graph. Keeping
+// the algorithm behind an interface lets us select the backend per
+// deployment (Config::Arbitrage::detector_algorithm) and A/B detection
+// latency between algorithms via PerformanceStats.
+class CycleDetector {
+public:
+  virtual ~CycleDetector() = default;
+
+  virtual const char *name() const = 0;
+
+  // Find negative cycles reachable from the given source vertices. Edges
+  // stamped before `min_updated_ns` are treated as absent (lazy expiry);
+  // 0 disables the age filter.
+  virtual std::vector<Cycle> find_cycles(const SparsePriceGraph &graph,
+                                         const std::vector<size_t> &sources,
+                                         uint64_t min_updated_ns) = 0;
+};
+
+// Classic per-source Bellman-Ford: V-1 relaxation passes per source with
+// early termination. This is the engine's original algorithm, kept as the
+// conservative default.
+class BellmanFordDetector : public CycleDetector {
+public:
+  const char *name() const override { return "bellman_ford"; }
+  std::vector<Cycle> find_cycles(const SparsePriceGraph &graph,
+                                 const std::vector<size_t> &sources,
+                                 uint64_t min_updated_ns) override;
+
+private:
+  DetectionScratch scratch_;
+};
+
+// SPFA (Shortest-Path-Faster-Algorithm): only re-relaxes vertices whose
+// distance actually improved, tracked with a deque and an in-queue bitmap.
+// A vertex relaxed V or more times sits on (or hangs off) a negative cycle.
+// On sparse graphs this typically terminates orders of magnitude faster
+// than the full Bellman-Ford sweep.
+class SpfaDetector : public CycleDetector {
+public:
+  const char *name() const override { return "spfa"; }
+  std::vector<Cycle> find_cycles(const SparsePriceGraph &graph,
+                                 const std::vector<size_t> &sources,
+                                 uint64_t min_updated_ns) override;
+
+private:
+  DetectionScratch scratch_;
+};
+
+// Bounded-hop enumeration for triangular (k<=3) and 4-leg (k<=4)
+// arbitrage. Instead of solving shortest paths, it walks every simple
+// cycle of at most max_cycle_length edges through each source and keeps
+// the ones whose weights sum negative. The DFS is unrolled at compile
+// time via a template on the remaining hop count, so each cycle length
+// compiles to its own fully inlined loop nest - microseconds over a few
+// thousand live edges where the relaxation-based backends spend
+// milliseconds. Cycles longer than the bound are invisible by design;
+// selected via Config::Arbitrage::enable_triangle_arbitrage.
+class HopLimitedDetector : public CycleDetector {
+public:
+  explicit HopLimitedDetector(uint32_t max_cycle_length)
+      : four_leg_(max_cycle_length >= 4) {}
+
+  const char *name() const override { return "hop_limited"; }
+  std::vector<Cycle> find_cycles(const SparsePriceGraph &graph,
+                                 const std::vector<size_t> &sources,
+                                 uint64_t min_updated_ns) override;
+
+private:
+  bool four_leg_;
+  Cycle path_; // reused DFS scratch
+};
+
+// Factory keyed by the config enum; max_cycle_length only matters for
+// HOP_LIMITED.
+std::unique_ptr<CycleDetector> make_cycle_detector(DetectorAlgorithm algorithm,
+                                                   uint32_t max_cycle_length = 3);
+
+} // namespace arbitrage
@@ -0,0 +1,139 @@
+// detection_pool.cpp - Worker pool for parallel negative-cycle detection
+#include "detection_pool.h"
+#include "thread_topology.h"
+
+namespace arbitrage {
+
+DetectionPool::DetectionPool(const Config::Threading &threading,
+                             DetectorAlgorithm algorithm,
+                             uint32_t max_cycle_length,
+                             const std::vector<int> &worker_cpus)
+    : threading_(threading), algorithm_(algorithm),
+      max_cycle_length_(max_cycle_length), worker_cpus_(worker_cpus),
+      inline_detector_(make_cycle_detector(algorithm, max_cycle_length)) {
+  // The calling (detection) thread always processes one shard itself, so
+  // the pool only needs num_processor_threads - 1 extra workers
+  size_t extra =
+      threading_.num_processor_threads > 1
+          ? static_cast<size_t>(threading_.num_processor_threads) - 1
+          : 0;
+
+  workers_ = std::vector<Worker>(extra);
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    workers_[i].detector = make_cycle_detector(algorithm_, max_cycle_length_);
+    workers_[i].thread = std::thread([this, i] { worker_loop(i); });
+  }
+}
+
+DetectionPool::~DetectionPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  work_cv_.notify_all();
+  for (auto &worker : workers_) {
+    if (worker.thread.joinable()) {
+      worker.thread.join();
+    }
+  }
+}
+
+std::vector<Cycle>
+DetectionPool::find_cycles(const SparsePriceGraph &graph,
+                           const std::vector<size_t> &sources,
+                           uint64_t min_updated_ns) {
+  const size_t shards = workers_.size() + 1;
+
+  if (shards == 1 || sources.size() < 2 * shards) {
+    // Too little work to be worth a handoff; run inline
+    return inline_detector_->find_cycles(graph, sources, min_updated_ns);
+  }
+
+  // Round-robin shard assignment balances sources of uneven cost
+  std::vector<size_t> own_shard;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto &worker : workers_) {
+      worker.shard.clear();
+      worker.results.clear();
+    }
+    for (size_t i = 0; i < sources.size(); ++i) {
+      size_t shard = i % shards;
+      if (shard == 0) {
+        own_shard.push_back(sources[i]);
+      } else {
+        workers_[shard - 1].shard.push_back(sources[i]);
+      }
+    }
+
+    current_graph_ = &graph;
+    current_min_updated_ns_ = min_updated_ns;
+    pending_workers_ = workers_.size();
+    ++pass_generation_;
+  }
+  work_cv_.notify_all();
+
+  // The detection thread pulls its own weight while the workers run
+  std::vector<Cycle> cycles =
+      inline_detector_->find_cycles(graph, own_shard, min_updated_ns);
+
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this] { return pending_workers_ == 0; });
+    current_graph_ = nullptr;
+
+    for (auto &worker : workers_) {
+      for (auto &cycle : worker.results) {
+        cycles.push_back(std::move(cycle));
+      }
+      worker.results.clear();
+    }
+  }
+
+  return cycles;
+}
+
+void DetectionPool::worker_loop(size_t worker_index) {
+  if (worker_index < worker_cpus_.size()) {
+    ThreadPlacement::pin_current_thread(worker_cpus_[worker_index]);
+  } else if (threading_.pin_threads && !threading_.cpu_affinity.empty()) {
+    ThreadPlacement::pin_current_thread(
+        threading_.cpu_affinity[worker_index %
+                                threading_.cpu_affinity.size()]);
+  }
+
+  Worker &self = workers_[worker_index];
+  uint64_t seen_generation = 0;
+
+  while (true) {
+    const SparsePriceGraph *graph = nullptr;
+    uint64_t min_updated_ns = 0;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      work_cv_.wait(lock, [&] {
+        return stopping_ || pass_generation_ != seen_generation;
+      });
+      if (stopping_) {
+        return;
+      }
+      seen_generation = pass_generation_;
+      graph = current_graph_;
+      min_updated_ns = current_min_updated_ns_;
+    }
+
+    std::vector<Cycle> results;
+    if (graph != nullptr && !self.shard.empty()) {
+      results = self.detector->find_cycles(*graph, self.shard, min_updated_ns);
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      self.results = std::move(results);
+      if (--pending_workers_ == 0) {
+        done_cv_.notify_one();
+      }
+    }
+  }
+}
+
+} // namespace arbitrage
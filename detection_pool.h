@@ -0,0 +1,77 @@
+// detection_pool.h - Worker pool sharding cycle detection across cores
+#pragma once
+
+#include "cpp-types-header.h"
+#include "cycle_detector.h"
+#include "sparse_graph.h"
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace arbitrage {
+
+// Shards the per-source loop of negative-cycle detection across a pool of
+// persistent worker threads. Sources are embarrassingly parallel: each
+// worker runs its own CycleDetector instance (with its own dist/parent
+// scratch) over a round-robin slice of the sources and writes results into
+// a private output slot, so the merge needs no locking - the detection
+// thread just concatenates the slots after the pass completes.
+//
+// Workers honor Config::Threading: num_processor_threads sizes the pool,
+// and each worker pins to its `worker_cpus` slot (assigned by the
+// engine's ThreadPlacement; see thread_topology.h). When no slots are
+// given, pin_threads falls back to the cpu_affinity entries modulo the
+// pool size. With a pool size of one, find_cycles() runs inline on the
+// caller with no handoff cost.
+class DetectionPool {
+public:
+  DetectionPool(const Config::Threading &threading, DetectorAlgorithm algorithm,
+                uint32_t max_cycle_length = 3,
+                const std::vector<int> &worker_cpus = {});
+  ~DetectionPool();
+
+  DetectionPool(const DetectionPool &) = delete;
+  DetectionPool &operator=(const DetectionPool &) = delete;
+
+  // Run one detection pass over `sources`, blocking until all shards finish.
+  // Edges stamped before `min_updated_ns` are skipped (0 = no age filter).
+  // Called from the detection thread only.
+  std::vector<Cycle> find_cycles(const SparsePriceGraph &graph,
+                                 const std::vector<size_t> &sources,
+                                 uint64_t min_updated_ns);
+
+  size_t worker_count() const { return workers_.size() + 1; }
+
+private:
+  void worker_loop(size_t worker_index);
+
+  Config::Threading threading_;
+  DetectorAlgorithm algorithm_;
+  uint32_t max_cycle_length_;
+  std::vector<int> worker_cpus_;
+
+  // Inline detector for the caller's shard (and the pool-of-one case)
+  std::unique_ptr<CycleDetector> inline_detector_;
+
+  struct Worker {
+    std::thread thread;
+    std::unique_ptr<CycleDetector> detector;
+    std::vector<size_t> shard;       // sources assigned for the current pass
+    std::vector<Cycle> results;      // private output slot
+  };
+  std::vector<Worker> workers_;
+
+  // Pass coordination
+  std::mutex mutex_;
+  std::condition_variable work_cv_;
+  std::condition_variable done_cv_;
+  const SparsePriceGraph *current_graph_ = nullptr;
+  uint64_t current_min_updated_ns_ = 0;
+  uint64_t pass_generation_ = 0;
+  size_t pending_workers_ = 0;
+  bool stopping_ = false;
+};
+
+} // namespace arbitrage
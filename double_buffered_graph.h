@@ -0,0 +1,132 @@
+// double_buffered_graph.h - Epoch-published double buffer over the price graph
+#pragma once
+
+#include "sparse_graph.h"
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#if defined(__x86_64__)
+#include <immintrin.h> // _mm_pause
+#endif
+
+namespace arbitrage {
+
+// Two SparsePriceGraph copies with single-writer / single-reader epoch
+// publication. The processing thread used to mutate the graph while the
+// detection thread scanned it - a data race, plus constant cache-line
+// ping-pong between the two pinned cores. Here the writer applies each
+// batch to its private buffer and records the edges in a delta log;
+// publish() flips an atomic index so the reader's next pass sees the new
+// buffer, then replays the log into the stale buffer to re-converge.
+// The reader always scans an immutable, cache-resident snapshot.
+//
+// Reader protocol (one logical reader - the detection pass, including
+// the pool workers it coordinates): acquire_read() pins the published
+// buffer, release_read() unpins it. The writer never mutates a buffer
+// the reader has pinned; publish() waits (bounded, microseconds in
+// practice: one detection pass) for the reader to move off the buffer it
+// is about to recycle.
+class DoubleBufferedGraph {
+public:
+  explicit DoubleBufferedGraph(size_t max_vertices)
+      : buffers_{SparsePriceGraph(max_vertices),
+                 SparsePriceGraph(max_vertices)},
+        published_(0), reading_(-1), write_idx_(1) {}
+
+  size_t capacity() const { return buffers_[0].capacity(); }
+
+  // --- Writer side (processing thread only) ---------------------------
+
+  void upsert_edge(size_t u, size_t v, double weight, uint64_t updated_ns) {
+    buffers_[write_idx_].upsert_edge(u, v, weight, updated_ns);
+    pending_.push_back(Delta{static_cast<uint32_t>(u),
+                             static_cast<uint32_t>(v), weight, updated_ns});
+  }
+
+  // Flip the published index and bring the recycled buffer up to date.
+  // No-op when nothing changed since the last publish.
+  void publish() {
+    if (pending_.empty()) {
+      return;
+    }
+
+    uint32_t fresh = write_idx_;
+    uint32_t stale = 1 - fresh;
+    published_.store(fresh, std::memory_order_seq_cst);
+
+    // The reader may still be mid-scan on the stale buffer; wait for it
+    // to finish before replaying the log into it
+    while (reading_.load(std::memory_order_seq_cst) ==
+           static_cast<int32_t>(stale)) {
+#if defined(__x86_64__)
+      _mm_pause();
+#else
+      std::this_thread::yield();
+#endif
+    }
+
+    for (const Delta &delta : pending_) {
+      buffers_[stale].upsert_edge(delta.u, delta.v, delta.weight,
+                                  delta.updated_ns);
+    }
+    pending_.clear();
+    write_idx_ = stale;
+  }
+
+  // Writer-thread view of the freshest state (snapshot saves). Includes
+  // edges not yet published.
+  const SparsePriceGraph &writer_view() const { return buffers_[write_idx_]; }
+
+  // Pre-thread initialization only (snapshot restore): expose the write
+  // buffer for bulk loading, then mirror it into the other buffer.
+  SparsePriceGraph &writer_buffer() { return buffers_[write_idx_]; }
+  void publish_initial() { buffers_[1 - write_idx_] = buffers_[write_idx_]; }
+
+  // --- Reader side (detection thread only) ----------------------------
+
+  const SparsePriceGraph &acquire_read() {
+    for (;;) {
+      uint32_t idx = published_.load(std::memory_order_seq_cst);
+      reading_.store(static_cast<int32_t>(idx), std::memory_order_seq_cst);
+      // Re-check: a flip between the load and the store means the writer
+      // may already be recycling `idx`
+      if (published_.load(std::memory_order_seq_cst) == idx) {
+        return buffers_[idx];
+      }
+      reading_.store(-1, std::memory_order_seq_cst);
+    }
+  }
+
+  void release_read() { reading_.store(-1, std::memory_order_release); }
+
+  // --- Monitoring (any thread) ----------------------------------------
+
+  // Approximate size of the published graph for the stats/metrics scrape
+  // path. Deliberately not part of the acquire_read protocol (that is a
+  // single-reader contract owned by the detection thread); the counts
+  // only grow and a value one publish behind is fine for monitoring.
+  size_t edge_count_approx() const {
+    return buffers_[published_.load(std::memory_order_acquire)].edge_count();
+  }
+  size_t vertex_count_approx() const {
+    return buffers_[published_.load(std::memory_order_acquire)].vertex_count();
+  }
+
+private:
+  struct Delta {
+    uint32_t u;
+    uint32_t v;
+    double weight;
+    uint64_t updated_ns;
+  };
+
+  SparsePriceGraph buffers_[2];
+  std::atomic<uint32_t> published_;
+  std::atomic<int32_t> reading_; // -1 = reader not in a pass
+  uint32_t write_idx_;           // writer thread only
+  std::vector<Delta> pending_;   // edges applied since the last publish
+};
+
+} // namespace arbitrage
@@ -0,0 +1,78 @@
+// fee_model.h - Per-exchange taker-fee schedules folded into edge weights
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace arbitrage {
+
+enum class FeeModelKind : uint8_t {
+  ZERO_FEE = 0,  // promos, internal transfers
+  FLAT_FEE = 1,  // single taker rate (Binance, Kraken)
+  TIERED_FEE = 2 // rate depends on 30-day volume (Coinbase)
+};
+
+// One exchange's fee configuration. The tier arrays are only consulted
+// by the TIERED_FEE model; thresholds ascend and each threshold's fee
+// applies from that volume upward.
+struct FeeSchedule {
+  static const size_t MAX_TIERS = 4;
+
+  FeeModelKind kind = FeeModelKind::FLAT_FEE;
+  double taker_fee = 0.001; // fraction, e.g. 0.001 = 10 bps
+
+  size_t tier_count = 0;
+  double tier_volume[MAX_TIERS] = {0, 0, 0, 0}; // 30d volume thresholds
+  double tier_fee[MAX_TIERS] = {0, 0, 0, 0};
+  double volume_30d = 0.0; // our current rolling volume on this venue
+};
+
+// Compile-time specialized fee models: each specialization is a pure
+// function of the schedule with no virtual dispatch. They run once per
+// schedule - at engine construction - to produce the additive log-space
+// penalty the per-tick path applies; the tick path itself is a table
+// lookup and an add, with no branches on the fee model at all.
+template <FeeModelKind K> struct FeeModel;
+
+template <> struct FeeModel<FeeModelKind::ZERO_FEE> {
+  static double taker_fee(const FeeSchedule&) { return 0.0; }
+};
+
+template <> struct FeeModel<FeeModelKind::FLAT_FEE> {
+  static double taker_fee(const FeeSchedule& schedule) {
+    return schedule.taker_fee;
+  }
+};
+
+template <> struct FeeModel<FeeModelKind::TIERED_FEE> {
+  static double taker_fee(const FeeSchedule& schedule) {
+    double fee = schedule.taker_fee; // below the first threshold
+    for (size_t i = 0; i < schedule.tier_count; ++i) {
+      if (schedule.volume_30d >= schedule.tier_volume[i]) {
+        fee = schedule.tier_fee[i];
+      }
+    }
+    return fee;
+  }
+};
+
+inline double resolve_taker_fee(const FeeSchedule& schedule) {
+  switch (schedule.kind) {
+  case FeeModelKind::ZERO_FEE:
+    return FeeModel<FeeModelKind::ZERO_FEE>::taker_fee(schedule);
+  case FeeModelKind::TIERED_FEE:
+    return FeeModel<FeeModelKind::TIERED_FEE>::taker_fee(schedule);
+  case FeeModelKind::FLAT_FEE:
+  default:
+    return FeeModel<FeeModelKind::FLAT_FEE>::taker_fee(schedule);
+  }
+}
+
+// Additive log-space penalty for one fill on this venue: an edge weight
+// of -log(rate) becomes -log(rate * (1 - fee)) = -log(rate) + penalty.
+inline double fee_log_penalty(const FeeSchedule& schedule) {
+  return -std::log(1.0 - resolve_taker_fee(schedule));
+}
+
+} // namespace arbitrage
@@ -0,0 +1,607 @@
+// feed_handler.cpp - Exchange WebSocket clients and in-situ tick parsing
+#include "feed_handler.h"
+#include "arbitrage_engine.h"
+#include "websocket_util.h"
+
+#include <arpa/inet.h>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace arbitrage {
+
+namespace {
+
+const size_t RX_BUFFER_SIZE = 256 * 1024;
+
+// Locate the value of `"key":"..."` inside a raw JSON message and return
+// a pointer into the buffer - no copy, no DOM. Good enough for the fixed
+// ticker schemas the exchanges emit; anything structurally surprising
+// simply fails the lookup and the message is dropped as a parse error.
+bool json_string_field(char *data, size_t len, const char *key, char **value,
+                       size_t *value_len) {
+  char pattern[32];
+  int pattern_len = std::snprintf(pattern, sizeof(pattern), "\"%s\":\"", key);
+  if (pattern_len <= 0 || static_cast<size_t>(pattern_len) >= sizeof(pattern)) {
+    return false;
+  }
+
+  char *found = static_cast<char *>(
+      memmem(data, len, pattern, static_cast<size_t>(pattern_len)));
+  if (found == nullptr) {
+    return false;
+  }
+
+  char *start = found + pattern_len;
+  char *end = static_cast<char *>(
+      std::memchr(start, '"', len - static_cast<size_t>(start - data)));
+  if (end == nullptr) {
+    return false;
+  }
+  *value = start;
+  *value_len = static_cast<size_t>(end - start);
+  return true;
+}
+
+// Parse the numeric string at `value` in place. The terminating quote is
+// still in the buffer, so strtod stops on its own.
+double parse_price(char *value) { return std::strtod(value, nullptr); }
+
+} // namespace
+
+ExchangeFeedHandler::ExchangeFeedHandler(
+    ArbitrageEngine &engine, Exchange exchange, const Config::Network &network,
+    const std::vector<std::string> &symbols)
+    : engine_(engine), exchange_(exchange), network_(network),
+      running_(false), connected_(false), ticks_parsed_(0), parse_errors_(0),
+      reconnects_(0), fd_(-1), rx_(RX_BUFFER_SIZE), rx_len_(0) {
+  size_t idx = static_cast<size_t>(exchange);
+  if (idx < network_.feed_endpoints.size()) {
+    endpoint_ = network_.feed_endpoints[idx];
+  }
+
+  // Pre-compute the exchange-native spelling of every canonical pair so
+  // the message path never builds strings
+  for (const auto &canonical : symbols) {
+    auto slash = canonical.find('/');
+    if (slash == std::string::npos || canonical.size() >= 16) {
+      continue;
+    }
+
+    SymbolMapping m{};
+    std::memcpy(m.canonical, canonical.data(), canonical.size());
+    m.canonical_len = canonical.size();
+
+    std::string native;
+    switch (exchange_) {
+    case Exchange::BINANCE:
+      // "BTC/USDT" -> "BTCUSDT" (messages carry it uppercase, no slash)
+      native = canonical.substr(0, slash) + canonical.substr(slash + 1);
+      break;
+    case Exchange::COINBASE:
+      // "BTC/USDT" -> "BTC-USDT"
+      native = canonical;
+      native[slash] = '-';
+      break;
+    case Exchange::KRAKEN:
+    default:
+      // Kraken echoes the pair with the slash intact
+      native = canonical;
+      break;
+    }
+    if (native.size() >= sizeof(m.native)) {
+      continue;
+    }
+    std::memcpy(m.native, native.data(), native.size());
+    m.native_len = native.size();
+    symbols_.push_back(m);
+  }
+}
+
+ExchangeFeedHandler::~ExchangeFeedHandler() { stop(); }
+
+const char *ExchangeFeedHandler::name() const {
+  switch (exchange_) {
+  case Exchange::BINANCE:
+    return "binance";
+  case Exchange::COINBASE:
+    return "coinbase";
+  case Exchange::KRAKEN:
+    return "kraken";
+  default:
+    return "unknown";
+  }
+}
+
+void ExchangeFeedHandler::start(int pin_cpu) {
+  if (running_.exchange(true)) {
+    return;
+  }
+  thread_ = std::thread([this, pin_cpu] { run_loop(pin_cpu); });
+}
+
+void ExchangeFeedHandler::stop() {
+  running_.store(false);
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  close_socket();
+}
+
+void ExchangeFeedHandler::close_socket() {
+  if (fd_ >= 0) {
+    ::close(fd_);
+    fd_ = -1;
+  }
+  connected_.store(false, std::memory_order_release);
+  rx_len_ = 0;
+}
+
+void ExchangeFeedHandler::run_loop(int pin_cpu) {
+  ThreadPlacement::pin_current_thread(pin_cpu);
+
+  uint32_t failed_attempts = 0;
+  while (running_.load()) {
+    if (connect_and_handshake()) {
+      failed_attempts = 0; // a good session re-arms the retry budget
+      session_loop();
+      if (running_.load()) {
+        reconnects_.fetch_add(1, std::memory_order_relaxed);
+      }
+    } else {
+      ++failed_attempts;
+      if (failed_attempts >= network_.max_reconnect_attempts) {
+        return; // endpoint is gone; stay down rather than spin forever
+      }
+    }
+    close_socket();
+
+    // Backoff before the next attempt, responsive to stop()
+    uint32_t waited_ms = 0;
+    while (running_.load() && waited_ms < network_.reconnect_interval_ms) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      waited_ms += 50;
+    }
+  }
+}
+
+bool ExchangeFeedHandler::connect_and_handshake() {
+  if (endpoint_.host.empty() || endpoint_.port == 0 || symbols_.empty()) {
+    return false;
+  }
+
+  addrinfo hints{};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  addrinfo *res = nullptr;
+  char port_str[8];
+  std::snprintf(port_str, sizeof(port_str), "%u", endpoint_.port);
+  if (getaddrinfo(endpoint_.host.c_str(), port_str, &hints, &res) != 0 ||
+      res == nullptr) {
+    return false;
+  }
+
+  fd_ = ::socket(res->ai_family, SOCK_STREAM | SOCK_NONBLOCK, 0);
+  if (fd_ < 0) {
+    freeaddrinfo(res);
+    return false;
+  }
+
+  int rc = ::connect(fd_, res->ai_addr, res->ai_addrlen);
+  freeaddrinfo(res);
+  if (rc != 0 && errno != EINPROGRESS) {
+    return false;
+  }
+  if (rc != 0) {
+    pollfd pfd{fd_, POLLOUT, 0};
+    if (::poll(&pfd, 1, static_cast<int>(network_.websocket_timeout_ms)) <= 0) {
+      return false;
+    }
+    int err = 0;
+    socklen_t err_len = sizeof(err);
+    if (getsockopt(fd_, SOL_SOCKET, SO_ERROR, &err, &err_len) != 0 ||
+        err != 0) {
+      return false;
+    }
+  }
+
+  // RFC 6455 client handshake. permessage-deflate is never offered: the
+  // in-situ parser wants raw bytes, and enable_compression only governs
+  // the dashboard side.
+  uint8_t nonce[16];
+  for (auto &b : nonce) {
+    b = static_cast<uint8_t>(std::rand());
+  }
+  std::string key = ws::base64_encode(nonce, sizeof(nonce));
+
+  std::string request = "GET " + endpoint_.path + " HTTP/1.1\r\n" +
+                        "Host: " + endpoint_.host + "\r\n" +
+                        "Upgrade: websocket\r\n" +
+                        "Connection: Upgrade\r\n" +
+                        "Sec-WebSocket-Key: " + key + "\r\n" +
+                        "Sec-WebSocket-Version: 13\r\n\r\n";
+  if (!send_all(request.data(), request.size())) {
+    return false;
+  }
+
+  // Collect the HTTP response head
+  std::string response;
+  while (response.find("\r\n\r\n") == std::string::npos) {
+    pollfd pfd{fd_, POLLIN, 0};
+    if (::poll(&pfd, 1, static_cast<int>(network_.websocket_timeout_ms)) <= 0) {
+      return false;
+    }
+    char buf[1024];
+    ssize_t n = ::recv(fd_, buf, sizeof(buf), 0);
+    if (n <= 0) {
+      return false;
+    }
+    response.append(buf, static_cast<size_t>(n));
+    if (response.size() > 16384) {
+      return false;
+    }
+  }
+
+  if (response.find(" 101 ") == std::string::npos ||
+      response.find(ws::websocket_accept_key(key)) == std::string::npos) {
+    return false;
+  }
+
+  std::string subscribe = subscribe_message();
+  if (!send_frame(0x1, subscribe.data(), subscribe.size())) {
+    return false;
+  }
+
+  connected_.store(true, std::memory_order_release);
+  return true;
+}
+
+std::string ExchangeFeedHandler::subscribe_message() const {
+  std::string msg;
+  switch (exchange_) {
+  case Exchange::BINANCE: {
+    msg = "{\"method\":\"SUBSCRIBE\",\"params\":[";
+    for (size_t i = 0; i < symbols_.size(); ++i) {
+      if (i > 0) {
+        msg += ',';
+      }
+      msg += '"';
+      for (size_t c = 0; c < symbols_[i].native_len; ++c) {
+        msg += static_cast<char>(
+            std::tolower(static_cast<unsigned char>(symbols_[i].native[c])));
+      }
+      msg += "@bookTicker\"";
+    }
+    msg += "],\"id\":1}";
+    break;
+  }
+  case Exchange::COINBASE: {
+    msg = "{\"type\":\"subscribe\",\"product_ids\":[";
+    for (size_t i = 0; i < symbols_.size(); ++i) {
+      if (i > 0) {
+        msg += ',';
+      }
+      msg += '"';
+      msg.append(symbols_[i].native, symbols_[i].native_len);
+      msg += '"';
+    }
+    msg += "],\"channels\":[\"ticker\"]}";
+    break;
+  }
+  case Exchange::KRAKEN:
+  default: {
+    msg = "{\"event\":\"subscribe\",\"pair\":[";
+    for (size_t i = 0; i < symbols_.size(); ++i) {
+      if (i > 0) {
+        msg += ',';
+      }
+      msg += '"';
+      msg.append(symbols_[i].native, symbols_[i].native_len);
+      msg += '"';
+    }
+    msg += "],\"subscription\":{\"name\":\"ticker\"}}";
+    break;
+  }
+  }
+  return msg;
+}
+
+bool ExchangeFeedHandler::send_all(const void *data, size_t len) {
+  const char *p = static_cast<const char *>(data);
+  size_t sent = 0;
+  while (sent < len) {
+    ssize_t n = ::send(fd_, p + sent, len - sent, MSG_NOSIGNAL);
+    if (n > 0) {
+      sent += static_cast<size_t>(n);
+      continue;
+    }
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      pollfd pfd{fd_, POLLOUT, 0};
+      if (::poll(&pfd, 1, static_cast<int>(network_.websocket_timeout_ms)) >
+          0) {
+        continue;
+      }
+    }
+    return false;
+  }
+  return true;
+}
+
+// Client-to-server frames must be masked (RFC 6455 §5.1)
+bool ExchangeFeedHandler::send_frame(uint8_t opcode, const void *payload,
+                                     size_t len) {
+  std::string frame;
+  frame.reserve(len + 14);
+  frame.push_back(static_cast<char>(0x80 | opcode)); // FIN + opcode
+  if (len < 126) {
+    frame.push_back(static_cast<char>(0x80 | len));
+  } else if (len <= 0xFFFF) {
+    frame.push_back(static_cast<char>(0x80 | 126));
+    frame.push_back(static_cast<char>(len >> 8));
+    frame.push_back(static_cast<char>(len & 0xFF));
+  } else {
+    frame.push_back(static_cast<char>(0x80 | 127));
+    for (int i = 7; i >= 0; --i) {
+      frame.push_back(static_cast<char>(len >> (i * 8)));
+    }
+  }
+
+  uint8_t mask[4];
+  for (auto &b : mask) {
+    b = static_cast<uint8_t>(std::rand());
+  }
+  frame.append(reinterpret_cast<const char *>(mask), 4);
+
+  const uint8_t *p = static_cast<const uint8_t *>(payload);
+  for (size_t i = 0; i < len; ++i) {
+    frame.push_back(static_cast<char>(p[i] ^ mask[i & 3]));
+  }
+  return send_all(frame.data(), frame.size());
+}
+
+void ExchangeFeedHandler::session_loop() {
+  uint64_t last_rx_ns = monotonic_ns();
+  uint64_t timeout_ns =
+      static_cast<uint64_t>(network_.websocket_timeout_ms) * 1000000ULL;
+
+  while (running_.load()) {
+    pollfd pfd{fd_, POLLIN, 0};
+    int rc = ::poll(&pfd, 1, 100);
+    if (rc < 0) {
+      return;
+    }
+    if (rc == 0) {
+      // Silent feed: treat as dead after the configured timeout
+      if (monotonic_ns() - last_rx_ns > timeout_ns) {
+        return;
+      }
+      continue;
+    }
+
+    if (rx_len_ == rx_.size()) {
+      return; // single frame larger than the buffer; resync via reconnect
+    }
+    ssize_t n = ::recv(fd_, rx_.data() + rx_len_, rx_.size() - rx_len_, 0);
+    if (n <= 0) {
+      return; // closed or errored
+    }
+    rx_len_ += static_cast<size_t>(n);
+    last_rx_ns = monotonic_ns();
+
+    if (!process_rx_buffer()) {
+      return; // close frame or protocol violation
+    }
+  }
+}
+
+// Extract every complete frame currently buffered; partial frames stay
+// for the next recv() to finish.
+bool ExchangeFeedHandler::process_rx_buffer() {
+  size_t offset = 0;
+  while (rx_len_ - offset >= 2) {
+    uint8_t *hdr = reinterpret_cast<uint8_t *>(rx_.data()) + offset;
+    uint8_t opcode = hdr[0] & 0x0F;
+    bool masked = (hdr[1] & 0x80) != 0;
+    uint64_t payload_len = hdr[1] & 0x7F;
+    size_t header_len = 2;
+
+    if (payload_len == 126) {
+      if (rx_len_ - offset < 4) {
+        break;
+      }
+      payload_len = (static_cast<uint64_t>(hdr[2]) << 8) | hdr[3];
+      header_len = 4;
+    } else if (payload_len == 127) {
+      if (rx_len_ - offset < 10) {
+        break;
+      }
+      payload_len = 0;
+      for (int i = 0; i < 8; ++i) {
+        payload_len = (payload_len << 8) | hdr[2 + i];
+      }
+      header_len = 10;
+    }
+    if (masked) {
+      header_len += 4; // servers must not mask, but tolerate it
+    }
+    if (payload_len > rx_.size() - header_len) {
+      return false; // oversized frame; cannot ever buffer it
+    }
+    if (rx_len_ - offset < header_len + payload_len) {
+      break; // incomplete frame
+    }
+
+    char *payload = rx_.data() + offset + header_len;
+    if (masked) {
+      const uint8_t *mask = hdr + header_len - 4;
+      for (uint64_t i = 0; i < payload_len; ++i) {
+        payload[i] = static_cast<char>(static_cast<uint8_t>(payload[i]) ^
+                                       mask[i & 3]);
+      }
+    }
+
+    switch (opcode) {
+    case 0x1: // text - all exchange tickers are text frames
+      if (!handle_message(payload, static_cast<size_t>(payload_len))) {
+        parse_errors_.fetch_add(1, std::memory_order_relaxed);
+      }
+      break;
+    case 0x9: // ping -> pong with the same payload
+      if (!send_frame(0xA, payload, static_cast<size_t>(payload_len))) {
+        return false;
+      }
+      break;
+    case 0x8: // close
+      return false;
+    default: // binary/pong/continuation: nothing we subscribe to uses them
+      break;
+    }
+
+    offset += header_len + static_cast<size_t>(payload_len);
+  }
+
+  if (offset > 0 && offset < rx_len_) {
+    std::memmove(rx_.data(), rx_.data() + offset, rx_len_ - offset);
+  }
+  rx_len_ -= offset;
+  return true;
+}
+
+bool ExchangeFeedHandler::handle_message(char *data, size_t len) {
+  if (len == 0) {
+    return true;
+  }
+  switch (exchange_) {
+  case Exchange::BINANCE:
+    return parse_binance(data, len);
+  case Exchange::COINBASE:
+    return parse_coinbase(data, len);
+  case Exchange::KRAKEN:
+  default:
+    return parse_kraken(data, len);
+  }
+}
+
+const ExchangeFeedHandler::SymbolMapping *
+ExchangeFeedHandler::find_native(const char *sym, size_t len) const {
+  for (const auto &m : symbols_) {
+    if (m.native_len == len && std::memcmp(m.native, sym, len) == 0) {
+      return &m;
+    }
+  }
+  return nullptr;
+}
+
+// bookTicker stream:
+// {"u":400900217,"s":"BTCUSDT","b":"25.35","B":"31.21","a":"25.36","A":"40.66"}
+bool ExchangeFeedHandler::parse_binance(char *data, size_t len) {
+  char *sym;
+  size_t sym_len;
+  if (!json_string_field(data, len, "s", &sym, &sym_len)) {
+    // Subscription acks ({"result":null,"id":1}) have no symbol
+    return memmem(data, len, "\"result\"", 8) != nullptr;
+  }
+  const SymbolMapping *m = find_native(sym, sym_len);
+  if (m == nullptr) {
+    return false;
+  }
+
+  char *bid_s, *ask_s, *qty_s;
+  size_t field_len;
+  if (!json_string_field(data, len, "b", &bid_s, &field_len) ||
+      !json_string_field(data, len, "a", &ask_s, &field_len)) {
+    return false;
+  }
+  double volume = 0.0;
+  if (json_string_field(data, len, "B", &qty_s, &field_len)) {
+    volume = parse_price(qty_s);
+  }
+
+  engine_.update_price(exchange_, m->canonical, m->canonical_len,
+                       parse_price(bid_s), parse_price(ask_s), volume);
+  ticks_parsed_.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+// ticker channel:
+// {"type":"ticker","product_id":"BTC-USD","best_bid":"25.1",
+//  "best_ask":"25.2","last_size":"0.05",...}
+bool ExchangeFeedHandler::parse_coinbase(char *data, size_t len) {
+  char *type;
+  size_t type_len;
+  if (!json_string_field(data, len, "type", &type, &type_len)) {
+    return false;
+  }
+  if (type_len != 6 || std::memcmp(type, "ticker", 6) != 0) {
+    return true; // subscriptions ack, heartbeats: fine, not ticks
+  }
+
+  char *sym, *bid_s, *ask_s, *size_s;
+  size_t sym_len, field_len;
+  if (!json_string_field(data, len, "product_id", &sym, &sym_len)) {
+    return false;
+  }
+  const SymbolMapping *m = find_native(sym, sym_len);
+  if (m == nullptr) {
+    return false;
+  }
+  if (!json_string_field(data, len, "best_bid", &bid_s, &field_len) ||
+      !json_string_field(data, len, "best_ask", &ask_s, &field_len)) {
+    return false;
+  }
+  double volume = 0.0;
+  if (json_string_field(data, len, "last_size", &size_s, &field_len)) {
+    volume = parse_price(size_s);
+  }
+
+  engine_.update_price(exchange_, m->canonical, m->canonical_len,
+                       parse_price(bid_s), parse_price(ask_s), volume);
+  ticks_parsed_.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+// ticker channel (v1 array format):
+// [42,{"a":["25.2","1","1.5"],"b":["25.1","2","2.0"],...},"ticker","BTC/USDT"]
+bool ExchangeFeedHandler::parse_kraken(char *data, size_t len) {
+  if (data[0] == '{') {
+    // Event objects: subscriptionStatus, heartbeat, systemStatus
+    return memmem(data, len, "\"event\"", 7) != nullptr;
+  }
+  if (data[0] != '[') {
+    return false;
+  }
+
+  // Pair name is the last string element: ...,"BTC/USDT"]
+  if (data[len - 1] != ']' || len < 4 || data[len - 2] != '"') {
+    return false;
+  }
+  char *sym_end = data + len - 2;
+  char *sym = sym_end;
+  while (sym > data && sym[-1] != '"') {
+    --sym;
+  }
+  const SymbolMapping *m =
+      find_native(sym, static_cast<size_t>(sym_end - sym));
+  if (m == nullptr) {
+    return false;
+  }
+
+  char *ask_s = static_cast<char *>(memmem(data, len, "\"a\":[\"", 6));
+  char *bid_s = static_cast<char *>(memmem(data, len, "\"b\":[\"", 6));
+  if (ask_s == nullptr || bid_s == nullptr) {
+    return false;
+  }
+
+  engine_.update_price(exchange_, m->canonical, m->canonical_len,
+                       parse_price(bid_s + 6), parse_price(ask_s + 6), 0.0);
+  ticks_parsed_.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+} // namespace arbitrage
@@ -0,0 +1,104 @@
+// feed_handler.h - Native exchange WebSocket market-data feed handlers
+#pragma once
+
+#include "cpp-types-header.h"
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace arbitrage {
+
+class ArbitrageEngine;
+
+// Production front half of the pipeline: one handler (and one pinned
+// thread) per exchange, speaking the exchange's native WebSocket ticker
+// protocol and feeding parsed quotes straight into
+// ArbitrageEngine::update_price(). Replaces nothing - the simulator
+// remains the load-test harness - but until now update_price() had no
+// real market-data caller.
+//
+// I/O is non-blocking with poll()-based timeouts; a feed that goes
+// silent for Config::Network::websocket_timeout_ms or drops is
+// reconnected with reconnect_interval_ms backoff up to
+// max_reconnect_attempts (the counter resets on a successful session).
+// Messages are parsed in situ: field values are located and converted
+// directly inside the receive buffer, with no intermediate std::string
+// or DOM - the only copy is the parsed tick itself entering the SPSC
+// ring, which the engine does for every producer anyway.
+//
+// Each handler stays on its own thread, which keeps its exchange shard
+// strictly single-producer (see exchange_shard()).
+class ExchangeFeedHandler {
+public:
+  // `symbols` are canonical pair names ("BTC/USDT"); the handler derives
+  // the exchange-native spellings for subscription and message matching.
+  ExchangeFeedHandler(ArbitrageEngine &engine, Exchange exchange,
+                      const Config::Network &network,
+                      const std::vector<std::string> &symbols);
+  ~ExchangeFeedHandler();
+
+  ExchangeFeedHandler(const ExchangeFeedHandler &) = delete;
+  ExchangeFeedHandler &operator=(const ExchangeFeedHandler &) = delete;
+
+  // Spawn the feed thread; pin_cpu >= 0 pins it to that core.
+  void start(int pin_cpu = -1);
+  void stop();
+
+  const char *name() const;
+  bool connected() const {
+    return connected_.load(std::memory_order_acquire);
+  }
+  uint64_t ticks_parsed() const {
+    return ticks_parsed_.load(std::memory_order_relaxed);
+  }
+  uint64_t parse_errors() const {
+    return parse_errors_.load(std::memory_order_relaxed);
+  }
+  uint32_t reconnects() const {
+    return reconnects_.load(std::memory_order_relaxed);
+  }
+
+private:
+  // Exchange-native <-> canonical symbol mapping, fixed at construction
+  // so the message path is a memcmp scan over a handful of entries
+  struct SymbolMapping {
+    char native[24];
+    size_t native_len;
+    char canonical[16];
+    size_t canonical_len;
+  };
+
+  void run_loop(int pin_cpu);
+  bool connect_and_handshake();
+  void session_loop();
+  bool process_rx_buffer();
+  bool handle_message(char *data, size_t len);
+  bool parse_binance(char *data, size_t len);
+  bool parse_coinbase(char *data, size_t len);
+  bool parse_kraken(char *data, size_t len);
+  std::string subscribe_message() const;
+  bool send_all(const void *data, size_t len);
+  bool send_frame(uint8_t opcode, const void *payload, size_t len);
+  const SymbolMapping *find_native(const char *sym, size_t len) const;
+  void close_socket();
+
+  ArbitrageEngine &engine_;
+  Exchange exchange_;
+  Config::Network network_;
+  Config::Network::FeedEndpoint endpoint_;
+  std::vector<SymbolMapping> symbols_;
+
+  std::thread thread_;
+  std::atomic<bool> running_;
+  std::atomic<bool> connected_;
+  std::atomic<uint64_t> ticks_parsed_;
+  std::atomic<uint64_t> parse_errors_;
+  std::atomic<uint32_t> reconnects_;
+
+  int fd_;
+  std::vector<char> rx_; // partial-frame accumulation across recv() calls
+  size_t rx_len_;
+};
+
+} // namespace arbitrage
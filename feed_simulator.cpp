@@ -0,0 +1,262 @@
+// feed_simulator.cpp - Multi-exchange market data simulator and test harness
+#include "feed_simulator.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <thread>
+
+namespace arbitrage {
+
+FeedSimulator::FeedSimulator(ArbitrageEngine &engine, const Options &options)
+    : engine_(engine), options_(options), running_(false), ticks_sent_(0),
+      ticks_dropped_(0), injected_symbol_(-1), injected_exchange_(0),
+      injection_start_ns_(0), injection_detected_(true) {
+  // Build the currency universe from the symbol list and seed each currency
+  // with a plausible reference value
+  auto currency_index = [this](const std::string &name) -> uint16_t {
+    for (size_t i = 0; i < currencies_.size(); ++i) {
+      if (currencies_[i] == name) {
+        return static_cast<uint16_t>(i);
+      }
+    }
+    currencies_.push_back(name);
+    return static_cast<uint16_t>(currencies_.size() - 1);
+  };
+
+  for (const auto &symbol : options_.symbols) {
+    auto slash = symbol.find('/');
+    if (slash == std::string::npos) {
+      symbol_base_.push_back(0);
+      symbol_quote_.push_back(0);
+      continue;
+    }
+    symbol_base_.push_back(currency_index(symbol.substr(0, slash)));
+    symbol_quote_.push_back(currency_index(symbol.substr(slash + 1)));
+  }
+
+  std::mt19937_64 rng(options_.seed);
+  std::uniform_real_distribution<double> value_dist(1.0, 50000.0);
+  currency_value_ = std::vector<std::atomic<double>>(currencies_.size());
+  for (auto &value : currency_value_) {
+    value.store(value_dist(rng));
+  }
+}
+
+void FeedSimulator::on_opportunity(const ArbitrageOpportunity &opportunity) {
+  (void)opportunity;
+
+  // Attribute the first detection inside an open injection window to that
+  // injection and record the latency
+  if (injected_symbol_.load(std::memory_order_acquire) < 0) {
+    return; // no window open; spontaneous (noise) opportunity
+  }
+  if (injection_detected_.exchange(true, std::memory_order_acq_rel)) {
+    return; // already credited
+  }
+
+  double latency_ms =
+      static_cast<double>(monotonic_ns() -
+                          injection_start_ns_.load(std::memory_order_acquire)) /
+      1e6;
+  std::lock_guard<std::mutex> lock(results_mutex_);
+  detection_latencies_ms_.push_back(latency_ms);
+  ++injections_detected_;
+}
+
+void FeedSimulator::producer_loop(size_t producer_index,
+                                  uint32_t exchange_begin,
+                                  uint32_t exchange_end) {
+  if (!options_.producer_pin_cpus.empty()) {
+    ThreadPlacement::pin_current_thread(
+        options_.producer_pin_cpus[producer_index %
+                                   options_.producer_pin_cpus.size()]);
+  }
+
+  std::mt19937_64 rng(options_.seed + 1 + producer_index);
+  std::normal_distribution<double> walk(0.0, 0.0002);  // shared random walk
+  std::normal_distribution<double> noise(0.0, 0.0001); // per-exchange noise
+  std::uniform_real_distribution<double> volume_dist(0.1, 100.0);
+  std::uniform_int_distribution<size_t> symbol_pick(
+      0, options_.symbols.size() - 1);
+
+  const double spread = 0.0005; // 5 bps half-spread
+  uint64_t depth_countdown = 0;
+  uint32_t exchanges = exchange_end - exchange_begin;
+  double producer_tps =
+      options_.ticks_per_second /
+      static_cast<double>(std::max(1u, options_.producer_threads));
+  // Pace in bursts of 64 ticks to keep the sleep syscall rate sane
+  const uint64_t burst = 64;
+  auto burst_interval = std::chrono::nanoseconds(
+      static_cast<uint64_t>(1e9 * burst / std::max(producer_tps, 1.0)));
+
+  auto next_burst = std::chrono::steady_clock::now();
+  while (running_.load(std::memory_order_acquire)) {
+    for (uint64_t i = 0; i < burst; ++i) {
+      size_t sym = symbol_pick(rng);
+      uint32_t exch = exchange_begin + static_cast<uint32_t>(
+                                           i % std::max(1u, exchanges));
+
+      // Producer 0 advances the shared per-currency walk; everyone reads it
+      double base_value =
+          currency_value_[symbol_base_[sym]].load(std::memory_order_relaxed);
+      if (producer_index == 0) {
+        base_value *= 1.0 + walk(rng);
+        currency_value_[symbol_base_[sym]].store(base_value,
+                                                 std::memory_order_relaxed);
+      }
+      double quote_value =
+          currency_value_[symbol_quote_[sym]].load(std::memory_order_relaxed);
+
+      double mid = base_value / quote_value;
+      double local_mid = mid * (1.0 + noise(rng));
+      double bid = local_mid * (1.0 - spread);
+      double ask = local_mid * (1.0 + spread);
+
+      // Apply the active injection: skew this exchange's bid above every
+      // other exchange's ask to create a known cross-exchange cycle
+      if (injected_symbol_.load(std::memory_order_acquire) ==
+              static_cast<int32_t>(sym) &&
+          injected_exchange_.load(std::memory_order_acquire) == exch) {
+        bid = mid * (1.0 + spread + options_.injection_profit);
+        ask = bid * (1.0 + spread);
+      }
+
+      bool ok = engine_.update_price(static_cast<Exchange>(exch),
+                                     options_.symbols[sym], bid, ask,
+                                     volume_dist(rng));
+      ticks_sent_.fetch_add(1, std::memory_order_relaxed);
+      if (!ok) {
+        ticks_dropped_.fetch_add(1, std::memory_order_relaxed);
+      }
+
+      // Periodically refresh the pair's synthetic book: levels step away
+      // from the touch with geometrically decaying size, so volume
+      // estimation has realistic depth to walk
+      if (options_.depth_interval_ticks != 0 &&
+          ++depth_countdown % options_.depth_interval_ticks == 0) {
+        DepthLevel bids[4], asks[4];
+        double level_volume = volume_dist(rng) * 4.0;
+        for (size_t l = 0; l < 4; ++l) {
+          bids[l].price = bid * (1.0 - 0.0002 * static_cast<double>(l));
+          bids[l].volume = level_volume;
+          asks[l].price = ask * (1.0 + 0.0002 * static_cast<double>(l));
+          asks[l].volume = level_volume;
+          level_volume *= 0.5;
+        }
+        engine_.update_depth(static_cast<Exchange>(exch),
+                             options_.symbols[sym], bids, 4, asks, 4);
+      }
+    }
+
+    next_burst += burst_interval;
+    std::this_thread::sleep_until(next_burst);
+  }
+}
+
+FeedSimulator::Report FeedSimulator::run() {
+  Report report;
+  if (options_.symbols.empty() || options_.num_exchanges == 0) {
+    return report;
+  }
+
+  running_.store(true, std::memory_order_release);
+
+  // One producer per exchange range, mirroring num_exchange_threads
+  size_t producers = std::min<size_t>(std::max(1u, options_.producer_threads),
+                                      options_.num_exchanges);
+  std::vector<std::thread> threads;
+  uint32_t per = options_.num_exchanges / static_cast<uint32_t>(producers);
+  uint32_t extra = options_.num_exchanges % static_cast<uint32_t>(producers);
+  uint32_t begin = 0;
+  for (size_t p = 0; p < producers; ++p) {
+    uint32_t count = per + (p < extra ? 1 : 0);
+    uint32_t end = begin + count;
+    threads.emplace_back(
+        [this, p, begin, end] { producer_loop(p, begin, end); });
+    begin = end;
+  }
+
+  // Injection scheduler runs on the harness thread
+  auto run_start = std::chrono::steady_clock::now();
+  auto deadline =
+      run_start + std::chrono::duration<double>(options_.duration_seconds);
+  std::mt19937_64 rng(options_.seed + 0x9e3779b9);
+  std::uniform_int_distribution<size_t> symbol_pick(
+      0, options_.symbols.size() - 1);
+  std::uniform_int_distribution<uint32_t> exchange_pick(
+      0, options_.num_exchanges - 1);
+
+  while (std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(
+        std::chrono::duration<double>(options_.injection_interval_seconds));
+    if (std::chrono::steady_clock::now() >= deadline) {
+      break;
+    }
+
+    // Open a window
+    size_t sym = symbol_pick(rng);
+    uint32_t exch = exchange_pick(rng);
+    injection_detected_.store(false, std::memory_order_release);
+    injected_exchange_.store(exch, std::memory_order_release);
+    injection_start_ns_.store(monotonic_ns(), std::memory_order_release);
+    injected_symbol_.store(static_cast<int32_t>(sym),
+                           std::memory_order_release);
+    ++injections_;
+
+    std::this_thread::sleep_for(
+        std::chrono::duration<double>(options_.injection_duration_seconds));
+
+    // Close it
+    injected_symbol_.store(-1, std::memory_order_release);
+    injection_detected_.store(true, std::memory_order_release);
+  }
+
+  running_.store(false, std::memory_order_release);
+  for (auto &t : threads) {
+    t.join();
+  }
+
+  report.ticks_sent = ticks_sent_.load();
+  report.ticks_dropped = ticks_dropped_.load();
+  {
+    std::lock_guard<std::mutex> lock(results_mutex_);
+    report.injections = injections_;
+    report.injections_detected = injections_detected_;
+    if (!detection_latencies_ms_.empty()) {
+      double sum = 0.0;
+      double mn = detection_latencies_ms_.front();
+      double mx = mn;
+      for (double v : detection_latencies_ms_) {
+        sum += v;
+        mn = std::min(mn, v);
+        mx = std::max(mx, v);
+      }
+      report.min_detection_latency_ms = mn;
+      report.max_detection_latency_ms = mx;
+      report.avg_detection_latency_ms =
+          sum / static_cast<double>(detection_latencies_ms_.size());
+    }
+  }
+  return report;
+}
+
+void FeedSimulator::Report::print() const {
+  std::printf("Feed simulation report\n");
+  std::printf("  ticks sent:          %llu\n",
+              static_cast<unsigned long long>(ticks_sent));
+  std::printf("  ticks dropped:       %llu\n",
+              static_cast<unsigned long long>(ticks_dropped));
+  std::printf("  injected windows:    %llu\n",
+              static_cast<unsigned long long>(injections));
+  std::printf("  windows detected:    %llu\n",
+              static_cast<unsigned long long>(injections_detected));
+  if (injections_detected > 0) {
+    std::printf("  detection latency:   min %.2f ms / avg %.2f ms / max %.2f ms\n",
+                min_detection_latency_ms, avg_detection_latency_ms,
+                max_detection_latency_ms);
+  }
+}
+
+} // namespace arbitrage
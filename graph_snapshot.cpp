@@ -0,0 +1,133 @@
+// graph_snapshot.cpp - Warm-restart persistence for graph + currency index
+#include "graph_snapshot.h"
+#include "cpp-types-header.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace arbitrage {
+
+namespace {
+
+bool write_all(std::FILE* f, const void* data, size_t len) {
+  return std::fwrite(data, 1, len, f) == len;
+}
+
+bool read_all(std::FILE* f, void* data, size_t len) {
+  return std::fread(data, 1, len, f) == len;
+}
+
+} // namespace
+
+bool GraphSnapshot::save(const std::string& path,
+                         const SparsePriceGraph& graph,
+                         const SymbolTable& symbols, uint64_t sequence) {
+  // Write to a sibling temp file and rename into place so readers never
+  // observe a half-written snapshot
+  std::string tmp_path = path + ".tmp";
+  std::FILE* f = std::fopen(tmp_path.c_str(), "wb");
+  if (f == nullptr) {
+    return false;
+  }
+
+  Header header;
+  header.sequence = sequence;
+  header.captured_wall_ns = wall_clock_ns();
+  header.symbol_count = static_cast<uint32_t>(symbols.size());
+
+  std::vector<EdgeRecord> edges;
+  edges.reserve(graph.edge_count());
+  for (size_t u = 0; u < graph.vertex_count(); ++u) {
+    const auto& row = graph.row(u);
+    for (size_t i = 0; i < row.size(); ++i) {
+      edges.push_back(EdgeRecord{static_cast<uint32_t>(u), row.to[i],
+                                 row.weight[i], row.updated_ns[i]});
+    }
+  }
+  header.edge_count = static_cast<uint32_t>(edges.size());
+
+  bool ok = write_all(f, &header, sizeof(header));
+
+  for (uint32_t id = 0; ok && id < header.symbol_count; ++id) {
+    SymbolRecord record{};
+    if (!symbols.entry(static_cast<CurrencyId>(id), record.name,
+                       record.exchange)) {
+      ok = false;
+      break;
+    }
+    ok = write_all(f, &record, sizeof(record));
+  }
+
+  if (ok && !edges.empty()) {
+    ok = write_all(f, edges.data(), edges.size() * sizeof(EdgeRecord));
+  }
+
+  ok = std::fclose(f) == 0 && ok;
+  if (!ok) {
+    std::remove(tmp_path.c_str());
+    return false;
+  }
+  return std::rename(tmp_path.c_str(), path.c_str()) == 0;
+}
+
+bool GraphSnapshot::restore(const std::string& path, SparsePriceGraph& graph,
+                            SymbolTable& symbols, uint32_t max_edge_age_s,
+                            uint64_t& sequence_out,
+                            size_t& edges_restored_out,
+                            size_t& edges_skipped_out) {
+  std::FILE* f = std::fopen(path.c_str(), "rb");
+  if (f == nullptr) {
+    return false;
+  }
+
+  Header header;
+  if (!read_all(f, &header, sizeof(header)) || header.magic != Header::MAGIC ||
+      header.version != 1) {
+    std::fclose(f);
+    return false;
+  }
+
+  // Re-intern in saved id order: intern() hands out dense sequential ids,
+  // so every edge endpoint keeps the vertex index it was saved with
+  for (uint32_t id = 0; id < header.symbol_count; ++id) {
+    SymbolRecord record;
+    if (!read_all(f, &record, sizeof(record))) {
+      std::fclose(f);
+      return false;
+    }
+    CurrencyId assigned = symbols.intern(
+        record.name, strnlen(record.name, SymbolTable::MAX_NAME_LEN),
+        record.exchange);
+    if (assigned != static_cast<CurrencyId>(id)) {
+      std::fclose(f); // table was not empty; ids would be shifted
+      return false;
+    }
+  }
+
+  uint64_t now_ns = wall_clock_ns();
+  uint64_t max_age_ns = static_cast<uint64_t>(max_edge_age_s) * 1000000000ULL;
+  edges_restored_out = 0;
+  edges_skipped_out = 0;
+
+  for (uint32_t i = 0; i < header.edge_count; ++i) {
+    EdgeRecord record;
+    if (!read_all(f, &record, sizeof(record))) {
+      std::fclose(f);
+      return false;
+    }
+    if (record.updated_ns + max_age_ns < now_ns) {
+      ++edges_skipped_out; // stale price; better blind than wrong
+      continue;
+    }
+    graph.upsert_edge(record.from, record.to, record.weight,
+                      record.updated_ns);
+    ++edges_restored_out;
+  }
+
+  std::fclose(f);
+  sequence_out = header.sequence;
+  return true;
+}
+
+} // namespace arbitrage
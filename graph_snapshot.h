@@ -0,0 +1,65 @@
+// graph_snapshot.h - Warm-restart persistence for graph + currency index
+#pragma once
+
+#include "sparse_graph.h"
+#include "symbol_table.h"
+#include <cstdint>
+#include <string>
+
+namespace arbitrage {
+
+// Compact binary snapshot of the engine's warm state: the interned
+// currency table, every live graph edge with its last-update wall-clock
+// time, and the tick sequence counter. Restoring one at startup removes
+// the post-deploy blackout where the graph is empty until every pair has
+// ticked at least once.
+//
+// Layout: Header, then `symbol_count` SymbolRecords in id order (so
+// re-interning reproduces the same dense ids), then `edge_count`
+// EdgeRecords. Written atomically via rename() from a temp file, so a
+// crash mid-write never leaves a truncated snapshot in place.
+class GraphSnapshot {
+public:
+  struct Header {
+    static const uint64_t MAGIC = 0x3150414E53425241ULL; // "ARBSNAP1"
+
+    uint64_t magic = MAGIC;
+    uint32_t version = 1;
+    uint32_t reserved = 0;
+    uint64_t sequence = 0;       // engine tick sequence counter
+    uint64_t captured_wall_ns = 0;
+    uint32_t symbol_count = 0;
+    uint32_t edge_count = 0;
+  };
+
+  struct SymbolRecord {
+    char name[SymbolTable::MAX_NAME_LEN + 1];
+    uint8_t exchange;
+    uint8_t pad[3] = {0, 0, 0};
+  };
+
+  struct EdgeRecord {
+    uint32_t from;
+    uint32_t to;
+    double weight;
+    uint64_t updated_ns; // wall clock at last update
+  };
+
+  // Serialize the current graph + symbol table. Must be called from the
+  // thread that owns graph writes (the processing thread) for a
+  // consistent view. Returns false on I/O failure.
+  static bool save(const std::string& path, const SparsePriceGraph& graph,
+                   const SymbolTable& symbols, uint64_t sequence);
+
+  // Load a snapshot into an empty graph/symbol table. Edges whose
+  // last-update time is more than `max_edge_age_s` in the past are
+  // skipped. On success `sequence_out` receives the saved counter and
+  // `edges_restored_out` / `edges_skipped_out` the edge tallies. Returns
+  // false if the file is missing, truncated, or a different version.
+  static bool restore(const std::string& path, SparsePriceGraph& graph,
+                      SymbolTable& symbols, uint32_t max_edge_age_s,
+                      uint64_t& sequence_out, size_t& edges_restored_out,
+                      size_t& edges_skipped_out);
+};
+
+} // namespace arbitrage
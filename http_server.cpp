@@ -0,0 +1,699 @@
+// http_server.cpp - Non-blocking epoll HTTP server for the dashboard API
+#include "http_server.h"
+#include "websocket_util.h"
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sstream>
+#include <strings.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace arbitrage {
+
+namespace {
+
+bool set_nonblocking(int fd) {
+  int flags = fcntl(fd, F_GETFL, 0);
+  return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+// Convert engine timestamps to ISO-8601 for the dashboard
+std::string timestamp_to_string(const Timestamp &tp) {
+  auto system_tp =
+      std::chrono::time_point_cast<std::chrono::system_clock::duration>(
+          tp - std::chrono::high_resolution_clock::now() +
+          std::chrono::system_clock::now());
+  auto time_tp = std::chrono::system_clock::to_time_t(system_tp);
+  char buf[32];
+  std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ",
+                std::gmtime(&time_tp));
+  return buf;
+}
+
+std::string serialize_opportunity(const ArbitrageOpportunity &opp) {
+  std::ostringstream ss;
+  ss << "{";
+  ss << "\"path\":\"" << opp.path << "\",";
+  ss << "\"profit_percentage\":" << opp.profit_percentage << ",";
+  ss << "\"max_volume\":" << opp.max_volume << ",";
+  ss << "\"confidence\":" << opp.confidence << ",";
+  ss << "\"detected_at\":\"" << timestamp_to_string(opp.detected_at) << "\"";
+  ss << "}";
+  return ss.str();
+}
+
+std::string
+serialize_opportunities(const std::vector<ArbitrageOpportunity> &opps) {
+  std::ostringstream ss;
+  ss << "[";
+  for (size_t i = 0; i < opps.size(); ++i) {
+    if (i > 0)
+      ss << ",";
+    ss << serialize_opportunity(opps[i]);
+  }
+  ss << "]";
+  return ss.str();
+}
+
+std::string serialize_stats(const PerformanceStats::Snapshot &stats) {
+  std::ostringstream ss;
+  ss << "{";
+  ss << "\"messages_processed\":" << stats.messages_processed << ",";
+  ss << "\"opportunities_found\":" << stats.opportunities_found << ",";
+  ss << "\"opportunities_deduped\":" << stats.opportunities_deduped << ",";
+  ss << "\"cross_exchange_alerts\":" << stats.cross_exchange_alerts << ",";
+  ss << "\"ticks_coalesced\":" << stats.ticks_coalesced << ",";
+  ss << "\"avg_latency_us\":" << stats.avg_latency_us << ",";
+  ss << "\"queues\":[";
+  for (size_t i = 0; i < NUM_EXCHANGE_SHARDS; ++i) {
+    if (i > 0)
+      ss << ",";
+    ss << "{\"depth\":" << stats.queue_depth[i]
+       << ",\"dropped\":" << stats.queue_dropped[i] << "}";
+  }
+  ss << "],";
+  ss << "\"stages\":{";
+  bool first = true;
+  for (uint8_t s = 0; s < NUM_PIPELINE_STAGES; ++s) {
+    const auto &h = stats.stages[s];
+    if (h.count == 0)
+      continue;
+    if (!first)
+      ss << ",";
+    first = false;
+    ss << "\"" << pipeline_stage_name(s) << "\":{"
+       << "\"count\":" << h.count << ",\"p50_us\":" << h.p50_us
+       << ",\"p99_us\":" << h.p99_us << ",\"p999_us\":" << h.p999_us
+       << ",\"max_us\":" << h.max_us << "}";
+  }
+  ss << "}}";
+  return ss.str();
+}
+
+// Exchange label for an ingestion shard (the fixed mapping from
+// exchange_shard(); the last shard is the catch-all)
+const char *shard_exchange_label(size_t shard) {
+  switch (shard) {
+  case 0:  return "binance";
+  case 1:  return "coinbase";
+  case 2:  return "kraken";
+  default: return "other";
+  }
+}
+
+// Prometheus text exposition (version 0.0.4). The per-shard values come
+// straight from the padded per-producer counter slots, aggregated here at
+// scrape time - per-exchange tick rates are then just
+// rate(arbitrage_ticks_ingested_total[1m]) on the Prometheus side. Stage
+// latencies export as summaries with precomputed quantiles; the raw HDR
+// buckets stay internal.
+std::string serialize_metrics(const PerformanceStats::Snapshot &stats) {
+  std::ostringstream ss;
+
+  ss << "# HELP arbitrage_ticks_ingested_total Ticks accepted into the "
+        "ingestion ring, per exchange shard\n"
+     << "# TYPE arbitrage_ticks_ingested_total counter\n";
+  for (size_t i = 0; i < NUM_EXCHANGE_SHARDS; ++i) {
+    ss << "arbitrage_ticks_ingested_total{exchange=\""
+       << shard_exchange_label(i) << "\",shard=\"" << i << "\"} "
+       << stats.ticks_ingested[i] << "\n";
+  }
+
+  ss << "# HELP arbitrage_ticks_dropped_total Ticks rejected because the "
+        "shard's ring was full\n"
+     << "# TYPE arbitrage_ticks_dropped_total counter\n";
+  for (size_t i = 0; i < NUM_EXCHANGE_SHARDS; ++i) {
+    ss << "arbitrage_ticks_dropped_total{exchange=\""
+       << shard_exchange_label(i) << "\",shard=\"" << i << "\"} "
+       << stats.queue_dropped[i] << "\n";
+  }
+
+  ss << "# HELP arbitrage_queue_depth Instantaneous ingestion ring "
+        "occupancy, per exchange shard\n"
+     << "# TYPE arbitrage_queue_depth gauge\n";
+  for (size_t i = 0; i < NUM_EXCHANGE_SHARDS; ++i) {
+    ss << "arbitrage_queue_depth{exchange=\"" << shard_exchange_label(i)
+       << "\",shard=\"" << i << "\"} " << stats.queue_depth[i] << "\n";
+  }
+
+  ss << "# HELP arbitrage_ticks_coalesced_total Ticks superseded by a "
+        "newer same-pair tick before graph application\n"
+     << "# TYPE arbitrage_ticks_coalesced_total counter\n"
+     << "arbitrage_ticks_coalesced_total " << stats.ticks_coalesced << "\n";
+
+  ss << "# HELP arbitrage_opportunities_found_total Arbitrage "
+        "opportunities emitted\n"
+     << "# TYPE arbitrage_opportunities_found_total counter\n"
+     << "arbitrage_opportunities_found_total " << stats.opportunities_found
+     << "\n";
+
+  ss << "# HELP arbitrage_opportunities_deduped_total Repeat cycles "
+        "suppressed within the dedup TTL\n"
+     << "# TYPE arbitrage_opportunities_deduped_total counter\n"
+     << "arbitrage_opportunities_deduped_total "
+     << stats.opportunities_deduped << "\n";
+
+  ss << "# HELP arbitrage_cross_exchange_alerts_total Two-leg "
+        "cross-exchange fast-path emissions\n"
+     << "# TYPE arbitrage_cross_exchange_alerts_total counter\n"
+     << "arbitrage_cross_exchange_alerts_total "
+     << stats.cross_exchange_alerts << "\n";
+
+  ss << "# HELP arbitrage_graph_edges Edges in the published price graph\n"
+     << "# TYPE arbitrage_graph_edges gauge\n"
+     << "arbitrage_graph_edges " << stats.graph_edges << "\n";
+
+  ss << "# HELP arbitrage_graph_vertices Vertices in the published price "
+        "graph\n"
+     << "# TYPE arbitrage_graph_vertices gauge\n"
+     << "arbitrage_graph_vertices " << stats.graph_vertices << "\n";
+
+  ss << "# HELP arbitrage_stage_latency_microseconds Pipeline stage "
+        "latency (enqueue through tick_to_alert)\n"
+     << "# TYPE arbitrage_stage_latency_microseconds summary\n";
+  for (uint8_t s = 0; s < NUM_PIPELINE_STAGES; ++s) {
+    const auto &h = stats.stages[s];
+    if (h.count == 0) {
+      continue;
+    }
+    const char *stage = pipeline_stage_name(s);
+    ss << "arbitrage_stage_latency_microseconds{stage=\"" << stage
+       << "\",quantile=\"0.5\"} " << h.p50_us << "\n"
+       << "arbitrage_stage_latency_microseconds{stage=\"" << stage
+       << "\",quantile=\"0.99\"} " << h.p99_us << "\n"
+       << "arbitrage_stage_latency_microseconds{stage=\"" << stage
+       << "\",quantile=\"0.999\"} " << h.p999_us << "\n"
+       << "arbitrage_stage_latency_microseconds_sum{stage=\"" << stage
+       << "\"} " << h.sum_us << "\n"
+       << "arbitrage_stage_latency_microseconds_count{stage=\"" << stage
+       << "\"} " << h.count << "\n";
+  }
+
+  return ss.str();
+}
+
+// --- WebSocket framing helpers (RFC 6455) -----------------------------
+//
+// The SHA-1/base64 handshake primitives are shared with the exchange
+// feed clients (websocket_util.h).
+
+// Server-to-client frames are unmasked (RFC 6455 §5.1)
+std::string encode_text_frame(const std::string &payload) {
+  std::string frame;
+  frame.reserve(payload.size() + 10);
+  frame.push_back(static_cast<char>(0x81)); // FIN + text opcode
+  if (payload.size() < 126) {
+    frame.push_back(static_cast<char>(payload.size()));
+  } else if (payload.size() <= 0xFFFF) {
+    frame.push_back(126);
+    frame.push_back(static_cast<char>(payload.size() >> 8));
+    frame.push_back(static_cast<char>(payload.size() & 0xFF));
+  } else {
+    frame.push_back(127);
+    for (int i = 7; i >= 0; --i) {
+      frame.push_back(static_cast<char>(payload.size() >> (i * 8)));
+    }
+  }
+  frame.append(payload);
+  return frame;
+}
+
+// Pull one header value out of a raw request buffer (case-insensitive name)
+std::string find_header(const std::string &request, const char *name) {
+  size_t name_len = std::strlen(name);
+  size_t pos = 0;
+  while ((pos = request.find("\r\n", pos)) != std::string::npos) {
+    pos += 2;
+    if (request.size() - pos < name_len + 1) {
+      break;
+    }
+    if (strncasecmp(request.c_str() + pos, name, name_len) == 0 &&
+        request[pos + name_len] == ':') {
+      size_t value_start = pos + name_len + 1;
+      while (value_start < request.size() && request[value_start] == ' ') {
+        ++value_start;
+      }
+      size_t value_end = request.find("\r\n", value_start);
+      if (value_end == std::string::npos) {
+        break;
+      }
+      return request.substr(value_start, value_end - value_start);
+    }
+  }
+  return "";
+}
+
+} // namespace
+
+HttpServer::HttpServer(ArbitrageEngine &engine, uint16_t port,
+                       const Config::Logging &logging)
+    : engine_(engine), port_(port), running_(false),
+      metrics_enabled_(logging.enable_metrics),
+      metrics_refresh_ms_(logging.metrics_interval_ms) {
+  health_response_ = render_response("{\"status\":\"ok\"}", "application/json");
+  not_found_response_ =
+      render_response("{\"error\":\"not found\"}", "application/json",
+                      "404 Not Found");
+}
+
+HttpServer::~HttpServer() { stop(); }
+
+std::string HttpServer::render_response(const std::string &body,
+                                        const char *content_type,
+                                        const char *status) {
+  std::ostringstream ss;
+  ss << "HTTP/1.1 " << status << "\r\n";
+  ss << "Content-Type: " << content_type << "\r\n";
+  ss << "Content-Length: " << body.length() << "\r\n";
+  ss << "Access-Control-Allow-Origin: *\r\n";
+  ss << "Connection: close\r\n";
+  ss << "\r\n";
+  ss << body;
+  return ss.str();
+}
+
+bool HttpServer::start(int pin_cpu) {
+  listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+  if (listen_fd_ < 0) {
+    return false;
+  }
+
+  int one = 1;
+  setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  addr.sin_port = htons(port_);
+  if (bind(listen_fd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) <
+          0 ||
+      listen(listen_fd_, 128) < 0 || !set_nonblocking(listen_fd_)) {
+    ::close(listen_fd_);
+    listen_fd_ = -1;
+    return false;
+  }
+
+  epoll_fd_ = epoll_create1(0);
+  if (epoll_fd_ < 0) {
+    ::close(listen_fd_);
+    listen_fd_ = -1;
+    return false;
+  }
+
+  epoll_event ev{};
+  ev.events = EPOLLIN;
+  ev.data.fd = listen_fd_;
+  epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, listen_fd_, &ev);
+
+  broadcast_event_fd_ = eventfd(0, EFD_NONBLOCK);
+  if (broadcast_event_fd_ >= 0) {
+    epoll_event bev{};
+    bev.events = EPOLLIN;
+    bev.data.fd = broadcast_event_fd_;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, broadcast_event_fd_, &bev);
+  }
+
+  running_.store(true);
+  server_thread_ = std::thread([this, pin_cpu] {
+    ThreadPlacement::pin_current_thread(pin_cpu);
+    server_loop();
+  });
+  return true;
+}
+
+void HttpServer::stop() {
+  if (!running_.exchange(false)) {
+    return;
+  }
+  if (server_thread_.joinable()) {
+    server_thread_.join();
+  }
+  for (auto &entry : connections_) {
+    ::close(entry.first);
+  }
+  connections_.clear();
+  if (broadcast_event_fd_ >= 0) {
+    ::close(broadcast_event_fd_);
+    broadcast_event_fd_ = -1;
+  }
+  if (epoll_fd_ >= 0) {
+    ::close(epoll_fd_);
+    epoll_fd_ = -1;
+  }
+  if (listen_fd_ >= 0) {
+    ::close(listen_fd_);
+    listen_fd_ = -1;
+  }
+}
+
+void HttpServer::refresh_opportunities_cache() {
+  uint64_t generation = engine_.opportunity_generation();
+  if (generation == rendered_generation_) {
+    return; // nothing new; serve the cached bytes
+  }
+  opportunities_response_ = render_response(
+      serialize_opportunities(engine_.get_recent_opportunities(100)),
+      "application/json");
+  rendered_generation_ = generation;
+}
+
+void HttpServer::refresh_stats_cache() {
+  uint64_t now_ns = monotonic_ns();
+  if (!stats_response_.empty() &&
+      now_ns - stats_rendered_ns_ < STATS_REFRESH_MS * 1000000ULL) {
+    return;
+  }
+  stats_response_ = render_response(
+      serialize_stats(engine_.get_performance_stats()), "application/json");
+  stats_rendered_ns_ = now_ns;
+}
+
+void HttpServer::refresh_metrics_cache() {
+  uint64_t now_ns = monotonic_ns();
+  if (!metrics_response_.empty() &&
+      now_ns - metrics_rendered_ns_ < metrics_refresh_ms_ * 1000000ULL) {
+    return;
+  }
+  metrics_response_ =
+      render_response(serialize_metrics(engine_.get_performance_stats()),
+                      "text/plain; version=0.0.4");
+  metrics_rendered_ns_ = now_ns;
+}
+
+const std::string &HttpServer::response_for_path(const std::string &path) {
+  if (path == "/api/opportunities") {
+    refresh_opportunities_cache();
+    return opportunities_response_;
+  }
+  if (path == "/api/stats") {
+    refresh_stats_cache();
+    return stats_response_;
+  }
+  if (path == "/metrics" && metrics_enabled_) {
+    refresh_metrics_cache();
+    return metrics_response_;
+  }
+  if (path == "/health") {
+    return health_response_;
+  }
+  return not_found_response_;
+}
+
+void HttpServer::broadcast_opportunity(
+    const ArbitrageOpportunity &opportunity) {
+  std::string message = serialize_opportunity(opportunity);
+  {
+    std::lock_guard<std::mutex> lock(broadcast_mutex_);
+    if (pending_broadcasts_.size() >= MAX_PENDING_BROADCASTS) {
+      broadcasts_dropped_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    pending_broadcasts_.push_back(std::move(message));
+  }
+  if (broadcast_event_fd_ >= 0) {
+    uint64_t one = 1;
+    ssize_t ignored = write(broadcast_event_fd_, &one, sizeof(one));
+    (void)ignored; // counter overflow just means a wakeup is already pending
+  }
+}
+
+void HttpServer::drain_broadcast_queue() {
+  uint64_t counter;
+  while (read(broadcast_event_fd_, &counter, sizeof(counter)) > 0) {
+  }
+
+  std::deque<std::string> messages;
+  {
+    std::lock_guard<std::mutex> lock(broadcast_mutex_);
+    messages.swap(pending_broadcasts_);
+  }
+  if (messages.empty()) {
+    return;
+  }
+
+  std::vector<int> evict;
+  for (auto &entry : connections_) {
+    Connection &conn = entry.second;
+    if (!conn.is_websocket) {
+      continue;
+    }
+    for (const auto &message : messages) {
+      conn.response += encode_text_frame(message);
+    }
+    if (conn.response.size() - conn.write_offset > MAX_CLIENT_BUFFERED) {
+      // Slow consumer: it hasn't drained the previous pushes, so cut it
+      // loose instead of buffering without bound
+      clients_evicted_.fetch_add(1, std::memory_order_relaxed);
+      evict.push_back(entry.first);
+      continue;
+    }
+    update_epoll_interest(entry.first, conn);
+  }
+  for (int fd : evict) {
+    close_connection(fd);
+  }
+}
+
+void HttpServer::update_epoll_interest(int fd, const Connection &conn) {
+  epoll_event ev{};
+  ev.events = EPOLLIN;
+  if (conn.write_offset < conn.response.size()) {
+    ev.events |= EPOLLOUT;
+  }
+  ev.data.fd = fd;
+  epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &ev);
+}
+
+void HttpServer::server_loop() {
+  epoll_event events[64];
+
+  while (running_.load()) {
+    int n = epoll_wait(epoll_fd_, events, 64, 100 /* ms */);
+    for (int i = 0; i < n; ++i) {
+      int fd = events[i].data.fd;
+
+      if (fd == broadcast_event_fd_) {
+        drain_broadcast_queue();
+        continue;
+      }
+
+      if (fd == listen_fd_) {
+        // Accept everything that is pending
+        while (true) {
+          int client = accept(listen_fd_, nullptr, nullptr);
+          if (client < 0) {
+            break;
+          }
+          if (!set_nonblocking(client)) {
+            ::close(client);
+            continue;
+          }
+          epoll_event cev{};
+          cev.events = EPOLLIN;
+          cev.data.fd = client;
+          epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, client, &cev);
+          connections_[client] = Connection{};
+        }
+        continue;
+      }
+
+      if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+        close_connection(fd);
+        continue;
+      }
+      if (events[i].events & EPOLLIN) {
+        handle_readable(fd);
+      }
+      if (events[i].events & EPOLLOUT) {
+        handle_writable(fd);
+      }
+    }
+  }
+}
+
+void HttpServer::handle_readable(int fd) {
+  auto it = connections_.find(fd);
+  if (it == connections_.end()) {
+    return;
+  }
+  Connection &conn = it->second;
+
+  char buf[4096];
+  while (true) {
+    ssize_t got = recv(fd, buf, sizeof(buf), 0);
+    if (got > 0) {
+      conn.request.append(buf, static_cast<size_t>(got));
+      if (conn.request.size() > 16384) {
+        close_connection(fd); // oversized request
+        return;
+      }
+    } else if (got == 0) {
+      close_connection(fd);
+      return;
+    } else {
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        break;
+      }
+      close_connection(fd);
+      return;
+    }
+  }
+
+  if (conn.is_websocket) {
+    handle_websocket_frames(fd, conn);
+    return;
+  }
+
+  // Wait for a complete header block
+  if (conn.request.find("\r\n\r\n") == std::string::npos) {
+    return;
+  }
+
+  // Parse "GET /path HTTP/1.1" - only GET is supported
+  std::string path;
+  if (conn.request.compare(0, 4, "GET ") == 0) {
+    size_t path_end = conn.request.find(' ', 4);
+    if (path_end != std::string::npos) {
+      path = conn.request.substr(4, path_end - 4);
+    }
+  }
+
+  if (path == "/ws/opportunities") {
+    if (!try_websocket_upgrade(fd, conn)) {
+      close_connection(fd);
+    }
+    return;
+  }
+
+  conn.response = response_for_path(path);
+  conn.write_offset = 0;
+
+  epoll_event ev{};
+  ev.events = EPOLLOUT;
+  ev.data.fd = fd;
+  epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &ev);
+  handle_writable(fd);
+}
+
+bool HttpServer::try_websocket_upgrade(int fd, Connection &conn) {
+  std::string key = find_header(conn.request, "Sec-WebSocket-Key");
+  std::string upgrade = find_header(conn.request, "Upgrade");
+  if (key.empty() || strcasecmp(upgrade.c_str(), "websocket") != 0) {
+    return false;
+  }
+
+  std::ostringstream ss;
+  ss << "HTTP/1.1 101 Switching Protocols\r\n";
+  ss << "Upgrade: websocket\r\n";
+  ss << "Connection: Upgrade\r\n";
+  ss << "Sec-WebSocket-Accept: " << ws::websocket_accept_key(key) << "\r\n";
+  ss << "\r\n";
+
+  conn.request.clear();
+  conn.response = ss.str();
+  conn.write_offset = 0;
+  conn.is_websocket = true;
+  update_epoll_interest(fd, conn);
+  return true;
+}
+
+void HttpServer::handle_websocket_frames(int fd, Connection &conn) {
+  // Clients only ever send us control frames worth reacting to; text and
+  // binary payloads are discarded
+  while (conn.request.size() >= 2) {
+    uint8_t opcode = static_cast<uint8_t>(conn.request[0]) & 0x0F;
+    uint8_t byte1 = static_cast<uint8_t>(conn.request[1]);
+    bool masked = (byte1 & 0x80) != 0;
+    uint64_t payload_len = byte1 & 0x7F;
+    size_t header_len = 2;
+    if (payload_len == 126) {
+      if (conn.request.size() < 4) {
+        return;
+      }
+      payload_len = (static_cast<uint64_t>(
+                         static_cast<uint8_t>(conn.request[2]))
+                     << 8) |
+                    static_cast<uint8_t>(conn.request[3]);
+      header_len = 4;
+    } else if (payload_len == 127) {
+      if (conn.request.size() < 10) {
+        return;
+      }
+      payload_len = 0;
+      for (int i = 0; i < 8; ++i) {
+        payload_len = (payload_len << 8) |
+                      static_cast<uint8_t>(conn.request[2 + i]);
+      }
+      header_len = 10;
+    }
+    if (masked) {
+      header_len += 4;
+    }
+    if (payload_len > 16384) {
+      close_connection(fd); // nothing legitimate is that big inbound
+      return;
+    }
+    if (conn.request.size() < header_len + payload_len) {
+      return; // partial frame
+    }
+
+    if (opcode == 0x8) { // close
+      close_connection(fd);
+      return;
+    }
+    if (opcode == 0x9) { // ping -> pong with empty payload
+      conn.response.push_back(static_cast<char>(0x8A));
+      conn.response.push_back(0);
+      update_epoll_interest(fd, conn);
+    }
+
+    conn.request.erase(0, header_len + static_cast<size_t>(payload_len));
+  }
+}
+
+void HttpServer::handle_writable(int fd) {
+  auto it = connections_.find(fd);
+  if (it == connections_.end()) {
+    return;
+  }
+  Connection &conn = it->second;
+
+  while (conn.write_offset < conn.response.size()) {
+    ssize_t sent =
+        send(fd, conn.response.data() + conn.write_offset,
+             conn.response.size() - conn.write_offset, MSG_NOSIGNAL);
+    if (sent > 0) {
+      conn.write_offset += static_cast<size_t>(sent);
+    } else if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      return; // try again on the next EPOLLOUT
+    } else {
+      close_connection(fd);
+      return;
+    }
+  }
+
+  if (conn.is_websocket) {
+    // Fully drained: release the buffer and go back to waiting for the
+    // next broadcast (or inbound control frame)
+    conn.response.clear();
+    conn.write_offset = 0;
+    update_epoll_interest(fd, conn);
+    return;
+  }
+  close_connection(fd); // Connection: close semantics
+}
+
+void HttpServer::close_connection(int fd) {
+  epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+  ::close(fd);
+  connections_.erase(fd);
+}
+
+} // namespace arbitrage
@@ -0,0 +1,137 @@
+// http_server.h - Non-blocking epoll HTTP server for the dashboard API
+#pragma once
+
+#include "arbitrage_engine.h"
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+namespace arbitrage {
+
+// Minimal epoll-based HTTP/1.1 server replacing the old stub that printed
+// its endpoints and slept forever. Serves:
+//
+//   GET /api/opportunities - recent arbitrage opportunities (JSON)
+//   GET /api/stats         - engine performance statistics (JSON)
+//   GET /metrics           - Prometheus exposition of the same counters
+//                            plus graph size and stage latency summaries
+//                            (when Config::Logging::enable_metrics; cached
+//                            for metrics_interval_ms between scrapes)
+//   GET /health            - liveness probe
+//   GET /ws/opportunities  - WebSocket upgrade; opportunities pushed as
+//                            JSON text frames the moment they are detected
+//
+// Responses are kept as fully pre-rendered HTTP buffers (headers + body).
+// The opportunities body is rebuilt only when the engine's opportunity
+// generation counter has advanced since the last render, and stats at most
+// every stats_refresh_ms - so a dozen dashboards polling at 4Hz hit cached
+// bytes, not the serializer. All sockets are non-blocking; a single server
+// thread multiplexes accept/read/write through one epoll instance.
+//
+// The WebSocket path decouples the detector from clients completely:
+// broadcast_opportunity() serializes the message and drops it into a
+// bounded queue (an eventfd wakes the server thread), so the detection
+// thread never touches a socket. Each subscriber has a bounded outbound
+// buffer; a client that stalls long enough for its buffer to fill is
+// evicted rather than allowed to apply backpressure upstream.
+class HttpServer {
+public:
+  HttpServer(ArbitrageEngine &engine, uint16_t port,
+             const Config::Logging &logging = Config::Logging());
+  ~HttpServer();
+
+  HttpServer(const HttpServer &) = delete;
+  HttpServer &operator=(const HttpServer &) = delete;
+
+  // Binds and spawns the server thread; pin_cpu >= 0 pins it to that
+  // core. Returns false if the socket could not be set up (port in use,
+  // etc.).
+  bool start(int pin_cpu = -1);
+  void stop();
+
+  uint16_t port() const { return port_; }
+
+  // Queue an opportunity for push to all WebSocket subscribers. Safe to
+  // call from any thread; never blocks (drops with a counter if the
+  // broadcast queue is full).
+  void broadcast_opportunity(const ArbitrageOpportunity &opportunity);
+
+  uint64_t broadcasts_dropped() const {
+    return broadcasts_dropped_.load(std::memory_order_relaxed);
+  }
+  uint64_t clients_evicted() const {
+    return clients_evicted_.load(std::memory_order_relaxed);
+  }
+
+private:
+  struct Connection {
+    std::string request;   // bytes read so far
+    std::string response;  // bytes to write
+    size_t write_offset = 0;
+    bool is_websocket = false;
+  };
+
+  void server_loop();
+  void handle_readable(int fd);
+  void handle_writable(int fd);
+  void close_connection(int fd);
+
+  // WebSocket support
+  bool try_websocket_upgrade(int fd, Connection &conn);
+  void handle_websocket_frames(int fd, Connection &conn);
+  void drain_broadcast_queue();
+  void update_epoll_interest(int fd, const Connection &conn);
+
+  // Cache maintenance + request routing
+  void refresh_opportunities_cache();
+  void refresh_stats_cache();
+  void refresh_metrics_cache();
+  const std::string &response_for_path(const std::string &path);
+
+  static std::string render_response(const std::string &body,
+                                     const char *content_type,
+                                     const char *status = "200 OK");
+
+  ArbitrageEngine &engine_;
+  uint16_t port_;
+
+  std::atomic<bool> running_;
+  std::thread server_thread_;
+  int listen_fd_ = -1;
+  int epoll_fd_ = -1;
+
+  std::unordered_map<int, Connection> connections_;
+
+  // Pre-rendered responses (server thread only; no locking needed)
+  std::string opportunities_response_;
+  std::string stats_response_;
+  std::string health_response_;
+  std::string not_found_response_;
+  uint64_t rendered_generation_ = UINT64_MAX;
+  uint64_t stats_rendered_ns_ = 0;
+  static const uint64_t STATS_REFRESH_MS = 250;
+
+  // Prometheus scrape cache (server thread only, like the caches above)
+  bool metrics_enabled_;
+  uint32_t metrics_refresh_ms_;
+  std::string metrics_response_;
+  uint64_t metrics_rendered_ns_ = 0;
+
+  // Broadcast handoff: producer threads append serialized messages here,
+  // the eventfd wakes the server thread to fan them out
+  int broadcast_event_fd_ = -1;
+  std::mutex broadcast_mutex_;
+  std::deque<std::string> pending_broadcasts_;
+  std::atomic<uint64_t> broadcasts_dropped_{0};
+  std::atomic<uint64_t> clients_evicted_{0};
+  static const size_t MAX_PENDING_BROADCASTS = 1024;
+  // Per-client outbound cap; exceeding it means the consumer is too slow
+  // to keep up and gets evicted
+  static const size_t MAX_CLIENT_BUFFERED = 256 * 1024;
+};
+
+} // namespace arbitrage
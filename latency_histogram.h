@@ -0,0 +1,148 @@
+// latency_histogram.h - Lock-free HDR-style latency histogram
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace arbitrage {
+
+// Log-bucketed histogram with 16 linear sub-buckets per power of two
+// (HdrHistogram-style), covering 1ns..~2^40ns (~18 minutes) with bounded
+// relative error. record() is three relaxed atomic adds plus an
+// occasional max CAS - safe from any thread, never locking, suitable for
+// the hot path. Percentiles are reconstructed at query time by scanning the
+// buckets; that is the scrape path's cost, not the recorder's.
+class LatencyHistogram {
+public:
+  static const unsigned SUB_BUCKET_BITS = 4; // 16 sub-buckets per octave
+  static const unsigned NUM_OCTAVES = 40;
+  static const size_t NUM_BUCKETS = (NUM_OCTAVES + 1) << SUB_BUCKET_BITS;
+
+  LatencyHistogram() : count_(0), sum_ns_(0), max_ns_(0) {
+    for (auto &bucket : counts_) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  void record(uint64_t ns) {
+    counts_[bucket_index(ns)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_ns_.fetch_add(ns, std::memory_order_relaxed);
+
+    uint64_t prev = max_ns_.load(std::memory_order_relaxed);
+    while (ns > prev &&
+           !max_ns_.compare_exchange_weak(prev, ns,
+                                          std::memory_order_relaxed)) {
+    }
+  }
+
+  struct Snapshot {
+    uint64_t count = 0;
+    double sum_us = 0.0; // for Prometheus summary _sum
+    double p50_us = 0.0;
+    double p99_us = 0.0;
+    double p999_us = 0.0;
+    double max_us = 0.0;
+  };
+
+  Snapshot snapshot() const {
+    Snapshot s;
+    uint64_t counts[NUM_BUCKETS];
+    uint64_t total = 0;
+    for (size_t i = 0; i < NUM_BUCKETS; ++i) {
+      counts[i] = counts_[i].load(std::memory_order_relaxed);
+      total += counts[i];
+    }
+    s.count = total;
+    s.sum_us = static_cast<double>(sum_ns_.load(std::memory_order_relaxed)) /
+               1000.0;
+    s.max_us = static_cast<double>(max_ns_.load(std::memory_order_relaxed)) /
+               1000.0;
+    if (total == 0) {
+      return s;
+    }
+
+    s.p50_us = percentile_from(counts, total, 0.50);
+    s.p99_us = percentile_from(counts, total, 0.99);
+    s.p999_us = percentile_from(counts, total, 0.999);
+    return s;
+  }
+
+private:
+  static size_t bucket_index(uint64_t ns) {
+    const uint64_t sub_count = 1ULL << SUB_BUCKET_BITS;
+    if (ns < sub_count) {
+      return static_cast<size_t>(ns); // exact for tiny values
+    }
+    unsigned exp = 63 - static_cast<unsigned>(__builtin_clzll(ns));
+    if (exp > NUM_OCTAVES + SUB_BUCKET_BITS - 1) {
+      exp = NUM_OCTAVES + SUB_BUCKET_BITS - 1; // clamp outliers
+    }
+    uint64_t sub = (ns >> (exp - SUB_BUCKET_BITS)) & (sub_count - 1);
+    return ((static_cast<size_t>(exp) - SUB_BUCKET_BITS + 1)
+            << SUB_BUCKET_BITS) |
+           static_cast<size_t>(sub);
+  }
+
+  // Lower bound of a bucket's value range, the inverse of bucket_index
+  static uint64_t bucket_value(size_t index) {
+    const uint64_t sub_count = 1ULL << SUB_BUCKET_BITS;
+    size_t octave = index >> SUB_BUCKET_BITS;
+    uint64_t sub = index & (sub_count - 1);
+    if (octave == 0) {
+      return sub;
+    }
+    unsigned exp = static_cast<unsigned>(octave) + SUB_BUCKET_BITS - 1;
+    return (sub_count | sub) << (exp - SUB_BUCKET_BITS);
+  }
+
+  static double percentile_from(const uint64_t *counts, uint64_t total,
+                                double p) {
+    uint64_t target = static_cast<uint64_t>(p * static_cast<double>(total));
+    if (target >= total) {
+      target = total - 1;
+    }
+    uint64_t seen = 0;
+    for (size_t i = 0; i < NUM_BUCKETS; ++i) {
+      seen += counts[i];
+      if (seen > target) {
+        return static_cast<double>(bucket_value(i)) / 1000.0;
+      }
+    }
+    return 0.0;
+  }
+
+  std::atomic<uint64_t> counts_[NUM_BUCKETS];
+  std::atomic<uint64_t> count_;
+  std::atomic<uint64_t> sum_ns_;
+  std::atomic<uint64_t> max_ns_;
+};
+
+// Pipeline stages instrumented end to end. TICK_TO_ALERT approximates true
+// tick-to-opportunity latency as (alert time - oldest tick in the batch
+// whose application produced the current graph state); per-edge timestamps
+// would tighten this further.
+enum PipelineStage : uint8_t {
+  STAGE_ENQUEUE = 0,     // update_price: build tick + ring enqueue
+  STAGE_QUEUE_WAIT,      // ring residency: enqueue -> dequeue
+  STAGE_GRAPH_UPDATE,    // coalesce + apply one batch
+  STAGE_DETECTION_PASS,  // one detector pass (incremental or full)
+  STAGE_CALLBACK,        // opportunity callback dispatch
+  STAGE_TICK_TO_ALERT,   // tick ingress -> opportunity emitted
+  NUM_PIPELINE_STAGES
+};
+
+inline const char *pipeline_stage_name(uint8_t stage) {
+  switch (stage) {
+  case STAGE_ENQUEUE:        return "enqueue";
+  case STAGE_QUEUE_WAIT:     return "queue_wait";
+  case STAGE_GRAPH_UPDATE:   return "graph_update";
+  case STAGE_DETECTION_PASS: return "detection_pass";
+  case STAGE_CALLBACK:       return "callback";
+  case STAGE_TICK_TO_ALERT:  return "tick_to_alert";
+  default:                   return "unknown";
+  }
+}
+
+} // namespace arbitrage
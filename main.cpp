@@ -1,190 +1,245 @@
 #include "arbitrage_engine.h"
 #include "cpp-types-header.h"
-#include <chrono>
-#include <ctime>
-#include <functional>
+#include "feed_handler.h"
+#include "feed_simulator.h"
+#include "http_server.h"
+#include "tick_journal.h"
+#include <memory>
+#include <cstdlib>
+#include <cstring>
 #include <iomanip>
 #include <iostream>
-#include <memory>
-#include <sstream>
 #include <string>
-#include <thread>
-#include <vector>
-
-// Simple HTTP server implementation using a lightweight approach
-// In a production environment, you would use a proper HTTP library like
-// cpp-httplib
-
-// Mock data for demonstration
-std::vector<arbitrage::ArbitrageOpportunity> mock_opportunities;
-arbitrage::PerformanceStats mock_stats;
-
-// Initialize mock data
-void initialize_mock_data() {
-  // Create some mock opportunities
-  arbitrage::ArbitrageOpportunity opp1;
-  opp1.path = "BTC_binance -> USDT_binance -> ETH_binance -> BTC_binance";
-  opp1.profit_percentage = 0.0045;
-  opp1.max_volume = 1250.0;
-  opp1.confidence = 94;
-  opp1.detected_at =
-      std::chrono::high_resolution_clock::now() - std::chrono::seconds(2);
-
-  arbitrage::ArbitrageOpportunity opp2;
-  opp2.path = "ETH_coinbase -> BTC_coinbase -> USDT_coinbase -> ETH_coinbase";
-  opp2.profit_percentage = 0.0032;
-  opp2.max_volume = 850.0;
-  opp2.confidence = 87;
-  opp2.detected_at =
-      std::chrono::high_resolution_clock::now() - std::chrono::seconds(5);
-
-  arbitrage::ArbitrageOpportunity opp3;
-  opp3.path = "BTC_binance -> BTC_kraken";
-  opp3.profit_percentage = 0.0028;
-  opp3.max_volume = 2000.0;
-  opp3.confidence = 91;
-  opp3.detected_at =
-      std::chrono::high_resolution_clock::now() - std::chrono::seconds(1);
-
-  mock_opportunities.push_back(opp1);
-  mock_opportunities.push_back(opp2);
-  mock_opportunities.push_back(opp3);
-
-  // Initialize mock stats
-  mock_stats.messages_processed.store(45623);
-  mock_stats.opportunities_found.store(127);
-  mock_stats.avg_latency_us.store(145.7);
-  mock_stats.last_update.store(std::chrono::high_resolution_clock::now());
-}
-
-// Convert timestamp to ISO string
-std::string
-timestamp_to_string(const std::chrono::high_resolution_clock::time_point &tp) {
-  // Convert to time_t by using system_clock
-  auto system_tp =
-      std::chrono::time_point_cast<std::chrono::system_clock::duration>(
-          tp - std::chrono::high_resolution_clock::now() +
-          std::chrono::system_clock::now());
-  auto time_tp = std::chrono::system_clock::to_time_t(system_tp);
-  std::stringstream ss;
-  ss << std::put_time(std::gmtime(&time_tp), "%Y-%m-%dT%H:%M:%SZ");
-  return ss.str();
-}
-
-// Simple JSON serialization for opportunities
-std::string serialize_opportunities(
-    const std::vector<arbitrage::ArbitrageOpportunity> &opportunities) {
-  std::stringstream ss;
-  ss << "[";
-
-  for (size_t i = 0; i < opportunities.size(); ++i) {
-    if (i > 0)
-      ss << ",";
-
-    ss << "{";
-    ss << "\"path\":\"" << opportunities[i].path << "\",";
-    ss << "\"profit_percentage\":" << opportunities[i].profit_percentage << ",";
-    ss << "\"max_volume\":" << opportunities[i].max_volume << ",";
-    ss << "\"confidence\":" << opportunities[i].confidence << ",";
-    ss << "\"detected_at\":\""
-       << timestamp_to_string(opportunities[i].detected_at) << "\"";
-    ss << "}";
-  }
-
-  ss << "]";
-  return ss.str();
-}
-
-// Simple JSON serialization for stats
-std::string serialize_stats(const arbitrage::PerformanceStats &stats) {
-  std::stringstream ss;
-  ss << "{";
-  ss << "\"messages_processed\":" << stats.messages_processed.load() << ",";
-  ss << "\"opportunities_found\":" << stats.opportunities_found.load() << ",";
-  ss << "\"avg_latency_us\":" << stats.avg_latency_us.load() << ",";
-  ss << "\"last_update\":\"" << timestamp_to_string(stats.last_update.load())
-     << "\"";
-  ss << "}";
-  return ss.str();
-}
-
-// Simple HTTP response generator
-std::string
-generate_http_response(const std::string &content,
-                       const std::string &content_type = "application/json") {
-  std::stringstream ss;
-  ss << "HTTP/1.1 200 OK\r\n";
-  ss << "Content-Type: " << content_type << "\r\n";
-  ss << "Content-Length: " << content.length() << "\r\n";
-  ss << "Access-Control-Allow-Origin: *\r\n";
-  ss << "Connection: close\r\n";
-  ss << "\r\n";
-  ss << content;
-  return ss.str();
-}
-
-// Simple HTTP server implementation
-void run_http_server(arbitrage::ArbitrageEngine &engine) {
-  // In a real implementation, you would use a proper HTTP server library
-  // For now, we'll just print the endpoints that would be available
-
-  std::cout << "HTTP Server running on port 8080\n";
-  std::cout << "Available endpoints:\n";
-  std::cout
-      << "  GET /api/opportunities - Get recent arbitrage opportunities\n";
-  std::cout << "  GET /api/stats - Get performance statistics\n";
-  std::cout << "  GET /health - Health check\n";
-
-  // Simulate server running
-  while (true) {
-    // In a real implementation, this would handle actual HTTP requests
-    std::this_thread::sleep_for(std::chrono::seconds(10));
-  }
-}
 
-int main() {
+// Entry point: runs the engine against the multi-exchange feed simulator
+// (feed_simulator.h) instead of the old hard-coded mock data, so an
+// end-to-end load test with ground-truth arbitrage injections is one
+// command away:
+//
+//   ./arbitrage_scanner [--duration SECONDS] [--tps TICKS_PER_SEC]
+//                       [--spfa] [--full-graph] [--k4]
+//                       [--journal PATH] [--snapshot PATH]
+//
+// or replays a previously captured journal through the engine (identical
+// tick sequence every run - see tick_journal.h):
+//
+//   ./arbitrage_scanner --replay PATH [--realtime] [--spfa]
+//
+// or runs against live exchange feeds (see feed_handler.h; endpoints in
+// Config::Network::feed_endpoints):
+//
+//   ./arbitrage_scanner --live [--duration SECONDS]
+
+int main(int argc, char **argv) {
   std::cout << "🚀 Real-time Cryptocurrency Arbitrage Scanner\n";
   std::cout << "=============================================\n";
 
-  // Initialize mock data
-  initialize_mock_data();
-
-  // Create config
   arbitrage::Config config;
 
-  // Create and start the arbitrage engine
+  arbitrage::FeedSimulator::Options sim_options;
+  sim_options.symbols = config.arbitrage.monitored_symbols;
+  // Cross pairs close triangles (e.g. ETH -> BTC -> USDT -> ETH) so the
+  // injected mispricings are actually reachable as graph cycles
+  sim_options.symbols.push_back("ETH/BTC");
+  sim_options.symbols.push_back("BNB/BTC");
+  // Ingestion is sharded per exchange, so each simulator producer owns a
+  // disjoint exchange range and its own single-producer ring
+  sim_options.producer_threads = 3;
+
+  std::string journal_path;
+  std::string replay_path;
+  bool replay_realtime = false;
+  bool live_feeds = false;
+
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--duration") == 0 && i + 1 < argc) {
+      sim_options.duration_seconds = std::atof(argv[++i]);
+    } else if (std::strcmp(argv[i], "--tps") == 0 && i + 1 < argc) {
+      sim_options.ticks_per_second = std::atof(argv[++i]);
+    } else if (std::strcmp(argv[i], "--spfa") == 0) {
+      // Picking an algorithm explicitly implies the full-graph search;
+      // hop-limited mode would shadow it otherwise
+      config.arbitrage.detector_algorithm = arbitrage::DetectorAlgorithm::SPFA;
+      config.arbitrage.enable_triangle_arbitrage = false;
+    } else if (std::strcmp(argv[i], "--full-graph") == 0) {
+      config.arbitrage.enable_triangle_arbitrage = false;
+    } else if (std::strcmp(argv[i], "--k4") == 0) {
+      config.arbitrage.max_cycle_length = 4;
+    } else if (std::strcmp(argv[i], "--journal") == 0 && i + 1 < argc) {
+      journal_path = argv[++i];
+    } else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+      replay_path = argv[++i];
+    } else if (std::strcmp(argv[i], "--realtime") == 0) {
+      replay_realtime = true;
+    } else if (std::strcmp(argv[i], "--live") == 0) {
+      live_feeds = true;
+    } else if (std::strcmp(argv[i], "--snapshot") == 0 && i + 1 < argc) {
+      config.persistence.snapshot_path = argv[++i];
+    } else {
+      std::cerr << "Unknown argument: " << argv[i] << "\n";
+      return 1;
+    }
+  }
+
   arbitrage::ArbitrageEngine engine(config);
-  engine.start();
+  // Simulator producers take the same FEED placement slots real feed
+  // handlers would, keeping the load test's producer/consumer cache
+  // geometry identical to production (see thread_topology.h)
+  for (uint32_t i = 0; i < sim_options.producer_threads; ++i) {
+    sim_options.producer_pin_cpus.push_back(
+        engine.placement().cpu_for(arbitrage::ThreadRole::FEED, i));
+  }
+  arbitrage::FeedSimulator simulator(engine, sim_options);
+  arbitrage::HttpServer http_server(engine, config.network.dashboard_port,
+                                    config.logging);
+
+  engine.register_opportunity_callback(
+      [&simulator, &http_server](const arbitrage::ArbitrageOpportunity &opp) {
+        simulator.on_opportunity(opp);
+        http_server.broadcast_opportunity(opp);
+      });
+
+  std::unique_ptr<arbitrage::JournalWriter> journal;
+  if (!journal_path.empty()) {
+    journal = std::make_unique<arbitrage::JournalWriter>(journal_path);
+    if (!journal->ok()) {
+      std::cerr << "Cannot open journal for writing: " << journal_path << "\n";
+      return 1;
+    }
+    engine.set_tick_journal(journal.get());
+  }
 
+  engine.start();
   std::cout << "✅ Arbitrage engine started\n";
 
-  // Register callback for opportunities (in a real implementation)
-  // engine.register_opportunity_callback([](const
-  // arbitrage::ArbitrageOpportunity& opp) {
-  //     std::cout << "🔍 New opportunity detected: " << opp.path
-  //               << " (" << std::fixed << std::setprecision(3)
-  //               << opp.profit_percentage * 100 << "%)\n";
-  // });
-
-  // Run HTTP server
-  run_http_server(engine);
-
-  // Keep the application running
-  // std::thread([]{
-  //     while (true) {
-  //         std::this_thread::sleep_for(std::chrono::seconds(30));
-  //         std::cout << "📈 System running - "
-  //                   << mock_stats.messages_processed.load() << " messages
-  //                   processed, "
-  //                   << mock_stats.opportunities_found.load() << "
-  //                   opportunities found\n";
-  //     }
-  // }).detach();
-
-  // Wait indefinitely
-  while (true) {
-    std::this_thread::sleep_for(std::chrono::hours(1));
+  if (http_server.start(
+          engine.placement().cpu_for(arbitrage::ThreadRole::SERVER))) {
+    std::cout << "🌐 Dashboard API listening on port " << http_server.port()
+              << "\n";
+  } else {
+    std::cerr << "⚠️  Could not bind dashboard port "
+              << config.network.dashboard_port << "; continuing without API\n";
+  }
+
+  if (!replay_path.empty()) {
+    arbitrage::JournalReader reader(replay_path);
+    if (!reader.ok()) {
+      std::cerr << "Cannot open journal for replay: " << replay_path << "\n";
+      return 1;
+    }
+    auto mode = replay_realtime
+                    ? arbitrage::JournalReader::ReplayMode::ORIGINAL_TIMING
+                    : arbitrage::JournalReader::ReplayMode::MAX_SPEED;
+    std::cout << "⏪ Replaying " << reader.size() << " ticks from "
+              << replay_path << (replay_realtime ? " at original timing"
+                                                 : " at max speed")
+              << "\n";
+
+    uint64_t replay_start = arbitrage::monotonic_ns();
+    uint64_t accepted = reader.replay(engine, mode);
+    double elapsed_s =
+        (arbitrage::monotonic_ns() - replay_start) / 1e9;
+
+    // Let the pipeline drain before tearing down
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    http_server.stop();
+    engine.stop();
+
+    std::cout << "Replay finished: " << accepted << "/" << reader.size()
+              << " ticks accepted in " << std::fixed << std::setprecision(2)
+              << elapsed_s << "s ("
+              << static_cast<uint64_t>(accepted / elapsed_s) << " ticks/s)\n";
+  } else if (live_feeds) {
+    // One handler (and one pinned thread) per exchange, capped by the
+    // configured exchange thread budget
+    const arbitrage::Exchange live_exchanges[] = {
+        arbitrage::Exchange::BINANCE, arbitrage::Exchange::COINBASE,
+        arbitrage::Exchange::KRAKEN};
+    size_t n_feeds = std::min<size_t>(
+        config.threading.num_exchange_threads,
+        sizeof(live_exchanges) / sizeof(live_exchanges[0]));
+
+    std::vector<std::unique_ptr<arbitrage::ExchangeFeedHandler>> feeds;
+    for (size_t i = 0; i < n_feeds; ++i) {
+      feeds.push_back(std::make_unique<arbitrage::ExchangeFeedHandler>(
+          engine, live_exchanges[i], config.network, sim_options.symbols));
+      feeds[i]->start(
+          engine.placement().cpu_for(arbitrage::ThreadRole::FEED, i));
+    }
+    std::cout << "📡 Live feeds: " << n_feeds << " exchanges, "
+              << sim_options.symbols.size() << " symbols for "
+              << sim_options.duration_seconds << "s\n";
+
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::duration<double>(sim_options.duration_seconds);
+    while (std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    }
+
+    for (auto &feed : feeds) {
+      feed->stop();
+    }
+    http_server.stop();
+    engine.stop();
+
+    std::cout << "Feed report\n";
+    for (const auto &feed : feeds) {
+      std::cout << "  " << std::setw(10) << std::left << feed->name()
+                << std::right << feed->ticks_parsed() << " ticks, "
+                << feed->parse_errors() << " parse errors, "
+                << feed->reconnects() << " reconnects"
+                << (feed->connected() ? "" : " (disconnected)") << "\n";
+    }
+  } else {
+    std::cout << "📡 Simulating " << sim_options.num_exchanges
+              << " exchanges, " << sim_options.symbols.size()
+              << " symbols at " << sim_options.ticks_per_second
+              << " ticks/sec for " << sim_options.duration_seconds << "s\n";
+
+    auto report = simulator.run();
+    http_server.stop();
+    engine.stop();
+
+    report.print();
+  }
+
+  if (journal) {
+    journal->close();
+    std::cout << "📼 Journal: " << journal->ticks_written()
+              << " ticks written, " << journal->ticks_dropped()
+              << " dropped (" << journal_path << ")\n";
+  }
+
+  auto stats = engine.get_performance_stats();
+  std::cout << "Engine stats\n";
+  std::cout << "  messages processed:  " << stats.messages_processed << "\n";
+  std::cout << "  ticks coalesced:     " << stats.ticks_coalesced << "\n";
+  std::cout << "  opportunities found: " << stats.opportunities_found << "\n";
+  std::cout << "  repeats suppressed:  " << stats.opportunities_deduped
+            << "\n";
+  std::cout << "  cross-exchange:      " << stats.cross_exchange_alerts
+            << "\n";
+  std::cout << "  avg enqueue latency: " << std::fixed << std::setprecision(2)
+            << stats.avg_latency_us << " µs\n";
+  std::cout << "  ingestion shards (depth / dropped):";
+  for (size_t i = 0; i < arbitrage::NUM_EXCHANGE_SHARDS; ++i) {
+    std::cout << "  [" << i << "] " << stats.queue_depth[i] << " / "
+              << stats.queue_dropped[i];
+  }
+  std::cout << "\n";
+  std::cout << "  pipeline stages (µs, p50 / p99 / p99.9 / max):\n";
+  for (uint8_t s = 0; s < arbitrage::NUM_PIPELINE_STAGES; ++s) {
+    const auto &h = stats.stages[s];
+    if (h.count == 0) {
+      continue;
+    }
+    std::cout << "    " << std::setw(14) << std::left
+              << arbitrage::pipeline_stage_name(s) << std::right << std::fixed
+              << std::setprecision(1) << std::setw(10) << h.p50_us << " /"
+              << std::setw(10) << h.p99_us << " /" << std::setw(10)
+              << h.p999_us << " /" << std::setw(10) << h.max_us << "  (n="
+              << h.count << ")\n";
   }
 
   return 0;
-}
\ No newline at end of file
+}
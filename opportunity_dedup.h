@@ -0,0 +1,101 @@
+// opportunity_dedup.h - Cycle-signature cache that suppresses repeat alerts
+#pragma once
+
+#include "cycle_detector.h"
+#include <cstdint>
+
+namespace arbitrage {
+
+// One mispricing surfaces as the same negative cycle from many source
+// vertices in a single pass, then again every detection interval until
+// it closes - dozens of identical alerts that used to eat the rate-limit
+// budget meant for *new* opportunities. This cache keys each cycle by
+// the canonical rotation of its vertex sequence (smallest vertex first;
+// direction is preserved because a reversed cycle is a different trade)
+// and suppresses repeats within a TTL.
+//
+// Fixed-size direct-mapped table, detection thread only - no locking, no
+// allocation. A hash collision at worst lets a duplicate through or
+// retires a live entry early; both are harmless.
+class OpportunityDedup {
+public:
+  explicit OpportunityDedup(uint64_t ttl_ms)
+      : ttl_ns_(ttl_ms * 1000000ULL), unique_(0), suppressed_(0) {
+    for (auto &entry : entries_) {
+      entry.signature = 0;
+    }
+  }
+
+  // True if this cycle has not alerted within the TTL (and records it).
+  bool should_alert(const Cycle &cycle, uint64_t now_ns) {
+    uint64_t signature = canonical_signature(cycle);
+    Entry &entry = entries_[signature & (TABLE_SIZE - 1)];
+
+    if (entry.signature == signature &&
+        now_ns - entry.last_seen_ns < ttl_ns_) {
+      entry.last_seen_ns = now_ns;
+      ++entry.hits;
+      ++suppressed_;
+      return false;
+    }
+
+    entry.signature = signature;
+    entry.first_seen_ns = now_ns;
+    entry.last_seen_ns = now_ns;
+    entry.hits = 1;
+    ++unique_;
+    return true;
+  }
+
+  // How long the cycle keyed by this signature has been continuously
+  // alive (re-observed within TTL), in nanoseconds.
+  uint64_t lifetime_ns(const Cycle &cycle) const {
+    uint64_t signature = canonical_signature(cycle);
+    const Entry &entry = entries_[signature & (TABLE_SIZE - 1)];
+    if (entry.signature != signature) {
+      return 0;
+    }
+    return entry.last_seen_ns - entry.first_seen_ns;
+  }
+
+  uint64_t unique_count() const { return unique_; }
+  uint64_t suppressed_count() const { return suppressed_; }
+
+private:
+  static const size_t TABLE_SIZE = 1024; // power of two
+
+  struct Entry {
+    uint64_t signature;
+    uint64_t first_seen_ns;
+    uint64_t last_seen_ns;
+    uint32_t hits;
+  };
+
+  // FNV-1a over the rotation starting at the smallest vertex, so the
+  // same cycle hashes identically no matter which source found it
+  static uint64_t canonical_signature(const Cycle &cycle) {
+    size_t n = cycle.size();
+    size_t start = 0;
+    for (size_t i = 1; i < n; ++i) {
+      if (cycle[i] < cycle[start]) {
+        start = i;
+      }
+    }
+
+    uint64_t h = 14695981039346656037ULL;
+    for (size_t i = 0; i < n; ++i) {
+      uint32_t v = static_cast<uint32_t>(cycle[(start + i) % n]);
+      h = (h ^ (v & 0xFF)) * 1099511628211ULL;
+      h = (h ^ ((v >> 8) & 0xFF)) * 1099511628211ULL;
+    }
+    h = (h ^ n) * 1099511628211ULL;
+    return h != 0 ? h : 1; // 0 is the empty-slot marker
+  }
+
+  uint64_t ttl_ns_;
+  Entry entries_[TABLE_SIZE];
+  uint64_t unique_;
+  uint64_t suppressed_;
+};
+
+} // namespace arbitrage
@@ -0,0 +1,87 @@
+// opportunity_ring.h - Lock-free ring buffer of recent opportunities
+#pragma once
+
+#include "cpp-types-header.h"
+#include <atomic>
+#include <vector>
+
+namespace arbitrage {
+
+// Fixed-capacity MPMC history ring for detected opportunities. Replaces the
+// old mutex + std::vector + erase(begin()) scheme, where the detection
+// thread memmoved up to 1000 entries while holding a lock that HTTP pollers
+// also took. Writers claim a slot with one fetch_add and publish it through
+// a per-slot seqlock; readers copy slots optimistically and discard any
+// entry whose seqlock changed mid-copy (i.e. it was overwritten while
+// reading). Neither side ever blocks the other.
+class OpportunityRing {
+public:
+  explicit OpportunityRing(size_t capacity = 1024)
+      : slots_(round_up_pow2(capacity)), mask_(slots_.size() - 1), head_(0) {}
+
+  OpportunityRing(const OpportunityRing &) = delete;
+  OpportunityRing &operator=(const OpportunityRing &) = delete;
+
+  void push(const ArbitrageOpportunity &opp) {
+    uint64_t idx = head_.fetch_add(1, std::memory_order_relaxed);
+    Slot &slot = slots_[idx & mask_];
+
+    uint64_t seq = slot.seq.load(std::memory_order_relaxed);
+    slot.seq.store(seq + 1, std::memory_order_release); // odd: in progress
+    slot.data = opp;
+    slot.seq.store(seq + 2, std::memory_order_release); // even: published
+  }
+
+  // Copy up to `limit` most recent entries, oldest first. Entries being
+  // overwritten during the copy are skipped rather than waited on.
+  std::vector<ArbitrageOpportunity> snapshot(size_t limit) const {
+    std::vector<ArbitrageOpportunity> out;
+    uint64_t head = head_.load(std::memory_order_acquire);
+    uint64_t count = head < slots_.size() ? head : slots_.size();
+    if (limit < count) {
+      count = limit;
+    }
+    out.reserve(count);
+
+    for (uint64_t i = head - count; i < head; ++i) {
+      const Slot &slot = slots_[i & mask_];
+
+      uint64_t seq_before = slot.seq.load(std::memory_order_acquire);
+      if (seq_before & 1) {
+        continue; // write in progress
+      }
+      ArbitrageOpportunity copy = slot.data;
+      uint64_t seq_after = slot.seq.load(std::memory_order_acquire);
+      if (seq_before == seq_after) {
+        out.push_back(std::move(copy));
+      }
+    }
+    return out;
+  }
+
+  // Monotonic count of pushes; lets consumers (e.g. the HTTP layer) detect
+  // whether anything changed since their last snapshot.
+  uint64_t generation() const { return head_.load(std::memory_order_acquire); }
+
+  size_t capacity() const { return slots_.size(); }
+
+private:
+  struct Slot {
+    std::atomic<uint64_t> seq{0}; // seqlock: odd while a writer is in flight
+    ArbitrageOpportunity data;
+  };
+
+  static size_t round_up_pow2(size_t n) {
+    size_t p = 1;
+    while (p < n) {
+      p <<= 1;
+    }
+    return p;
+  }
+
+  std::vector<Slot> slots_;
+  const size_t mask_;
+  std::atomic<uint64_t> head_;
+};
+
+} // namespace arbitrage
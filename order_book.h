@@ -0,0 +1,130 @@
+// order_book.h - Top-N depth storage per trading pair
+#pragma once
+
+#include "cpp-types-header.h"
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+namespace arbitrage {
+
+const size_t DEPTH_LEVELS = 8; // top-of-book levels kept per side
+
+struct DepthLevel {
+  Price price;
+  Volume volume; // base-currency units at this level
+};
+
+// Depth message that flows through the ingestion pipeline alongside
+// MarketTick: one update replaces both sides of a pair's book. Ids are
+// resolved at enqueue time, same as ticks. Levels are best-first.
+struct DepthUpdate {
+  uint16_t base_id;
+  uint16_t quote_id;
+  uint8_t bid_count;
+  uint8_t ask_count;
+  DepthLevel bids[DEPTH_LEVELS];
+  DepthLevel asks[DEPTH_LEVELS];
+};
+
+// Flat preallocated open-addressing store of per-pair books, mirroring
+// the symbol_table layout: lock-free reads, and writes are confined to
+// the processing thread (single writer), so each slot only needs a
+// seqlock to keep readers from observing torn levels. The table never
+// rehashes.
+class OrderBookStore {
+public:
+  static const size_t TABLE_SIZE = 8192; // power of two, ~2x max pairs
+
+  OrderBookStore() {
+    for (auto &slot : slots_) {
+      slot.state.store(0, std::memory_order_relaxed);
+      slot.seq.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  // Replace the book for (base, quote). Processing thread only.
+  void apply(const DepthUpdate &update) {
+    uint32_t key = make_key(update.base_id, update.quote_id);
+    size_t idx = hash_key(key) & (TABLE_SIZE - 1);
+
+    for (size_t probe = 0; probe < TABLE_SIZE; ++probe) {
+      Slot &slot = slots_[(idx + probe) & (TABLE_SIZE - 1)];
+      uint8_t state = slot.state.load(std::memory_order_relaxed);
+
+      if (state == 1 && slot.key != key) {
+        continue; // occupied by another pair
+      }
+
+      // Seqlock write: odd while mutating, even when published
+      uint32_t seq = slot.seq.load(std::memory_order_relaxed);
+      slot.seq.store(seq + 1, std::memory_order_release);
+      std::atomic_thread_fence(std::memory_order_release);
+
+      slot.key = key;
+      slot.book = update;
+
+      std::atomic_thread_fence(std::memory_order_release);
+      slot.seq.store(seq + 2, std::memory_order_release);
+      if (state == 0) {
+        slot.state.store(1, std::memory_order_release);
+      }
+      return;
+    }
+    // table full: drop the update (bounded store by design)
+  }
+
+  // Copy the current book for (base, quote) into `out`. Lock-free; false
+  // if no depth has been seen for the pair.
+  bool snapshot(uint16_t base_id, uint16_t quote_id, DepthUpdate &out) const {
+    uint32_t key = make_key(base_id, quote_id);
+    size_t idx = hash_key(key) & (TABLE_SIZE - 1);
+
+    for (size_t probe = 0; probe < TABLE_SIZE; ++probe) {
+      const Slot &slot = slots_[(idx + probe) & (TABLE_SIZE - 1)];
+      if (slot.state.load(std::memory_order_acquire) == 0) {
+        return false; // empty slot terminates the probe chain
+      }
+      if (slot.key != key) {
+        continue;
+      }
+
+      // Seqlock read: retry while a write is in flight or raced us
+      for (int attempt = 0; attempt < 16; ++attempt) {
+        uint32_t seq_before = slot.seq.load(std::memory_order_acquire);
+        if (seq_before & 1) {
+          continue;
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        out = slot.book;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.seq.load(std::memory_order_acquire) == seq_before) {
+          return true;
+        }
+      }
+      return false; // writer kept winning; treat as no data
+    }
+    return false;
+  }
+
+private:
+  struct Slot {
+    std::atomic<uint8_t> state; // 0 = empty, 1 = filled
+    std::atomic<uint32_t> seq;
+    uint32_t key;
+    DepthUpdate book;
+  };
+
+  static uint32_t make_key(uint16_t base_id, uint16_t quote_id) {
+    return (static_cast<uint32_t>(base_id) << 16) | quote_id;
+  }
+
+  static uint64_t hash_key(uint32_t key) {
+    // Fibonacci hashing; keys are dense small ids so identity would clump
+    return (static_cast<uint64_t>(key) * 11400714819323198485ULL) >> 32;
+  }
+
+  Slot slots_[TABLE_SIZE];
+};
+
+} // namespace arbitrage
@@ -0,0 +1,81 @@
+// price_math.h - Fixed-point price grid and fast log for edge weights
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace arbitrage {
+
+// Prices on an exact integer grid of 1e-8 quote units ("price ticks",
+// finer than any venue's real tick increment). Quantizing at the edge
+// makes price arithmetic exact: two feeds quoting the same price always
+// land on the same tick - and therefore produce bit-identical edge
+// weights - regardless of what double rounding their parsers or the
+// simulator's arithmetic picked up on the way in.
+class FixedPrice {
+public:
+  static const int64_t SCALE = 100000000; // 1e-8 grid
+
+  static FixedPrice from_double(double price) {
+    FixedPrice p;
+    p.ticks_ = static_cast<int64_t>(
+        std::llround(price * static_cast<double>(SCALE)));
+    return p;
+  }
+
+  int64_t ticks() const { return ticks_; }
+  double to_double() const {
+    return static_cast<double>(ticks_) / static_cast<double>(SCALE);
+  }
+  bool positive() const { return ticks_ > 0; }
+
+  bool operator==(FixedPrice other) const { return ticks_ == other.ticks_; }
+  bool operator!=(FixedPrice other) const { return ticks_ != other.ticks_; }
+  bool operator<(FixedPrice other) const { return ticks_ < other.ticks_; }
+  bool operator>(FixedPrice other) const { return ticks_ > other.ticks_; }
+
+private:
+  int64_t ticks_ = 0;
+};
+
+// log(x) without libm: split the double into exponent and mantissa with
+// bit operations, renormalize the mantissa into [1/sqrt2, sqrt2) and sum
+// the odd atanh series 2t(1 + t^2/3 + ... + t^8/9) with t = (m-1)/(m+1),
+// |t| <= 0.1716. Straight-line arithmetic - no branches past the
+// renormalize, no tables, so it vectorizes cleanly if a batch caller ever
+// wants it. Max absolute error stays under 1e-9 over the full positive
+// range (measured ~7e-10; validated against std::log in
+// bench/bench_engine.cpp); edge weights sit ~1e-3 from the profitability
+// threshold, six orders above that.
+//
+// Precondition: x > 0 and finite, which holds for every quoted price
+// that reaches the weight computation.
+inline double fast_log(double x) {
+  uint64_t bits;
+  std::memcpy(&bits, &x, sizeof(bits));
+  int64_t exponent = static_cast<int64_t>((bits >> 52) & 0x7FF) - 1023;
+
+  // Re-bias the mantissa into [1, 2)
+  uint64_t mantissa_bits =
+      (bits & 0x000FFFFFFFFFFFFFULL) | 0x3FF0000000000000ULL;
+  double m;
+  std::memcpy(&m, &mantissa_bits, sizeof(m));
+  if (m > 1.4142135623730951) { // keep the series argument small
+    m *= 0.5;
+    exponent += 1;
+  }
+
+  double t = (m - 1.0) / (m + 1.0);
+  double t2 = t * t;
+  double p = 1.0 / 9.0;
+  p = p * t2 + 1.0 / 7.0;
+  p = p * t2 + 1.0 / 5.0;
+  p = p * t2 + 1.0 / 3.0;
+  p = p * t2 + 1.0;
+
+  const double ln2 = 0.6931471805599453;
+  return static_cast<double>(exponent) * ln2 + 2.0 * t * p;
+}
+
+} // namespace arbitrage
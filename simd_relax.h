@@ -0,0 +1,125 @@
+// simd_relax.h - Vectorized edge relaxation kernel with runtime dispatch
+#pragma once
+
+#include "sparse_graph.h"
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace arbitrage {
+namespace simd {
+
+// Relax one adjacency row: dist[to[i]] = min(dist[to[i]], dist_u + weight[i]),
+// recording `u` as parent for every improved vertex. Returns true if any
+// distance improved. The row's struct-of-arrays layout (sparse_graph.h) puts
+// the weights in one contiguous double array, so the AVX2 path does a
+// broadcast add, a gather of the current distances, and a vector compare,
+// falling back to scalar writeback only for the (rare) improved lanes.
+//
+// Edges stamped before `cutoff_ns` are skipped as if absent (lazy expiry
+// of quotes whose feed went quiet). cutoff_ns == 0 keeps every edge and
+// costs one extra compare per lane, folded into the improvement mask.
+
+inline bool relax_row_scalar(double dist_u, const uint32_t *to,
+                             const double *weight, const uint64_t *updated_ns,
+                             size_t n, double *dist, int *parent, int u,
+                             uint64_t cutoff_ns) {
+  bool updated = false;
+  for (size_t i = 0; i < n; ++i) {
+    if (updated_ns[i] < cutoff_ns) {
+      continue; // stale edge: treat as infinite
+    }
+    double new_dist = dist_u + weight[i];
+    if (new_dist < dist[to[i]]) {
+      dist[to[i]] = new_dist;
+      parent[to[i]] = u;
+      updated = true;
+    }
+  }
+  return updated;
+}
+
+#if defined(__x86_64__)
+__attribute__((target("avx2"))) inline bool
+relax_row_avx2(double dist_u, const uint32_t *to, const double *weight,
+               const uint64_t *updated_ns, size_t n, double *dist, int *parent,
+               int u, uint64_t cutoff_ns) {
+  bool updated = false;
+  const __m256d v_dist_u = _mm256_set1_pd(dist_u);
+  // Signed compare is safe: nanosecond stamps stay far below 2^63
+  const __m256i v_cutoff_m1 =
+      _mm256_set1_epi64x(static_cast<int64_t>(cutoff_ns) - 1);
+
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256d v_weight = _mm256_loadu_pd(weight + i);
+    __m256d v_new = _mm256_add_pd(v_dist_u, v_weight);
+
+    __m128i v_to =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(to + i));
+    __m256d v_cur = _mm256_i32gather_pd(dist, v_to, sizeof(double));
+
+    // Fresh lanes: stamp > cutoff - 1; with cutoff 0 this is always true
+    __m256i v_stamp = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i *>(updated_ns + i));
+    __m256d v_fresh =
+        _mm256_castsi256_pd(_mm256_cmpgt_epi64(v_stamp, v_cutoff_m1));
+
+    __m256d v_lt =
+        _mm256_and_pd(_mm256_cmp_pd(v_new, v_cur, _CMP_LT_OQ), v_fresh);
+    int mask = _mm256_movemask_pd(v_lt);
+    if (mask == 0) {
+      continue; // common case: nothing improved in this vector
+    }
+
+    updated = true;
+    alignas(32) double new_dist[4];
+    _mm256_store_pd(new_dist, v_new);
+    for (int lane = 0; lane < 4; ++lane) {
+      if (mask & (1 << lane)) {
+        uint32_t v = to[i + lane];
+        // Re-check against dist: a duplicate target in earlier lanes may
+        // already have written a better value than the gather saw
+        if (new_dist[lane] < dist[v]) {
+          dist[v] = new_dist[lane];
+          parent[v] = u;
+        }
+      }
+    }
+  }
+
+  if (relax_row_scalar(dist_u, to + i, weight + i, updated_ns + i, n - i,
+                       dist, parent, u, cutoff_ns)) {
+    updated = true;
+  }
+  return updated;
+}
+#endif // __x86_64__
+
+using RelaxFn = bool (*)(double, const uint32_t *, const double *,
+                         const uint64_t *, size_t, double *, int *, int,
+                         uint64_t);
+
+inline RelaxFn select_relax_fn() {
+#if defined(__x86_64__)
+  if (__builtin_cpu_supports("avx2")) {
+    return relax_row_avx2;
+  }
+#endif
+  return relax_row_scalar;
+}
+
+// Dispatch is resolved once per process via CPUID; the indirect call is
+// amortized over the whole row.
+inline bool relax_row(double dist_u, const SparsePriceGraph::Row &row,
+                      double *dist, int *parent, int u, uint64_t cutoff_ns) {
+  static const RelaxFn fn = select_relax_fn();
+  return fn(dist_u, row.to.data(), row.weight.data(), row.updated_ns.data(),
+            row.size(), dist, parent, u, cutoff_ns);
+}
+
+} // namespace simd
+} // namespace arbitrage
@@ -0,0 +1,122 @@
+// sparse_graph.h - Sparse CSR-style price graph with incremental edge updates
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace arbitrage {
+
+// Sparse replacement for the old dense V x V weight matrix. With
+// MAX_EXCHANGES * MAX_SYMBOLS = 4096 vertices the dense matrix was ~128 MB
+// of mostly-infinity doubles, and every relaxation pass scanned all 16M
+// entries. Here edges live in per-vertex adjacency rows (compressed-sparse-
+// row style: each vertex owns a contiguous array of (target, weight) pairs),
+// so relaxation cost is proportional to the number of live edges - a few
+// thousand in a realistic 3-exchange / 40-symbol deployment.
+class SparsePriceGraph {
+public:
+  // Adjacency row in struct-of-arrays form: targets and weights live in
+  // separate contiguous arrays so the relaxation kernel (simd_relax.h) can
+  // load a full vector of weights and gather the matching distances.
+  struct Row {
+    std::vector<uint32_t> to;
+    std::vector<double> weight;
+    // Wall-clock time of the last update per edge; persisted by the
+    // snapshot codec so stale edges can be aged out on restore, and read
+    // by the detectors to lazily expire edges whose feed went quiet.
+    // Kept in its own array so the weight lanes stay contiguous.
+    std::vector<uint64_t> updated_ns;
+
+    size_t size() const { return to.size(); }
+  };
+
+  explicit SparsePriceGraph(size_t max_vertices)
+      : rows_(max_vertices), active_(max_vertices, 0), vertex_count_(0),
+        edge_count_(0) {}
+
+  size_t capacity() const { return rows_.size(); }
+
+  // Number of vertices that have ever been touched (high-water mark).
+  // Iteration bounds use this instead of the full capacity.
+  size_t vertex_count() const { return vertex_count_; }
+
+  size_t edge_count() const { return edge_count_; }
+
+  bool is_active(size_t v) const { return v < active_.size() && active_[v]; }
+
+  // Insert or overwrite the directed edge u -> v. O(out_degree(u)), which
+  // stays tiny in practice: a currency trades against a handful of quotes.
+  // `updated_ns` is the wall-clock update time recorded for the edge.
+  void upsert_edge(size_t u, size_t v, double weight,
+                   uint64_t updated_ns = 0) {
+    if (u >= rows_.size() || v >= rows_.size()) {
+      return;
+    }
+
+    touch_vertex(u);
+    touch_vertex(v);
+
+    auto &row = rows_[u];
+    for (size_t i = 0; i < row.to.size(); ++i) {
+      if (row.to[i] == v) {
+        row.weight[i] = weight;
+        row.updated_ns[i] = updated_ns;
+        return;
+      }
+    }
+
+    row.to.push_back(static_cast<uint32_t>(v));
+    row.weight.push_back(weight);
+    row.updated_ns.push_back(updated_ns);
+    ++edge_count_;
+  }
+
+  // Weight of u -> v, or +infinity if the edge does not exist (matches the
+  // sentinel the dense matrix used for absent edges).
+  double weight(size_t u, size_t v) const {
+    if (u < rows_.size()) {
+      const auto &row = rows_[u];
+      for (size_t i = 0; i < row.to.size(); ++i) {
+        if (row.to[i] == v) {
+          return row.weight[i];
+        }
+      }
+    }
+    return std::numeric_limits<double>::infinity();
+  }
+
+  // Last-update stamp of u -> v, or 0 if the edge does not exist. Cold
+  // path (per-cycle confidence scoring), same linear probe as weight().
+  uint64_t edge_updated_ns(size_t u, size_t v) const {
+    if (u < rows_.size()) {
+      const auto &row = rows_[u];
+      for (size_t i = 0; i < row.to.size(); ++i) {
+        if (row.to[i] == v) {
+          return row.updated_ns[i];
+        }
+      }
+    }
+    return 0;
+  }
+
+  const Row &row(size_t u) const { return rows_[u]; }
+
+private:
+  void touch_vertex(size_t v) {
+    if (!active_[v]) {
+      active_[v] = 1;
+      if (v + 1 > vertex_count_) {
+        vertex_count_ = v + 1;
+      }
+    }
+  }
+
+  std::vector<Row> rows_;
+  std::vector<uint8_t> active_; // avoids vector<bool> proxy in hot loops
+  size_t vertex_count_;
+  size_t edge_count_;
+};
+
+} // namespace arbitrage
@@ -0,0 +1,89 @@
+// spsc_queue.h - Bounded single-producer single-consumer ring buffer
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace arbitrage {
+
+// Wait-free bounded SPSC queue. Replaces the external
+// moodycamel::ReaderWriterQueue dependency and adds the bulk-drain
+// operation the processing thread needs for batched tick handling.
+// Head and tail live on separate cache lines to avoid producer/consumer
+// false sharing; each side caches the opposite index to skip most atomic
+// loads.
+template <typename T> class SpscQueue {
+public:
+  explicit SpscQueue(size_t capacity)
+      : capacity_(round_up_pow2(capacity)), mask_(capacity_ - 1),
+        buffer_(capacity_), head_(0), tail_(0), cached_head_(0),
+        cached_tail_(0) {}
+
+  SpscQueue(const SpscQueue &) = delete;
+  SpscQueue &operator=(const SpscQueue &) = delete;
+
+  // Producer side. Returns false when the ring is full (backpressure).
+  bool try_enqueue(const T &item) {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    size_t next = tail + 1;
+    if (next - cached_head_ > capacity_) {
+      cached_head_ = head_.load(std::memory_order_acquire);
+      if (next - cached_head_ > capacity_) {
+        return false;
+      }
+    }
+    buffer_[tail & mask_] = item;
+    tail_.store(next, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side.
+  bool try_dequeue(T &item) { return try_dequeue_bulk(&item, 1) == 1; }
+
+  // Drain up to `max` items into `out`; returns the number dequeued.
+  size_t try_dequeue_bulk(T *out, size_t max) {
+    size_t head = head_.load(std::memory_order_relaxed);
+    if (cached_tail_ == head) {
+      cached_tail_ = tail_.load(std::memory_order_acquire);
+      if (cached_tail_ == head) {
+        return 0;
+      }
+    }
+
+    size_t available = cached_tail_ - head;
+    size_t count = available < max ? available : max;
+    for (size_t i = 0; i < count; ++i) {
+      out[i] = buffer_[(head + i) & mask_];
+    }
+    head_.store(head + count, std::memory_order_release);
+    return count;
+  }
+
+  size_t size_approx() const {
+    return tail_.load(std::memory_order_acquire) -
+           head_.load(std::memory_order_acquire);
+  }
+
+  size_t capacity() const { return capacity_; }
+
+private:
+  static size_t round_up_pow2(size_t n) {
+    size_t p = 1;
+    while (p < n) {
+      p <<= 1;
+    }
+    return p;
+  }
+
+  const size_t capacity_;
+  const size_t mask_;
+  std::vector<T> buffer_;
+
+  alignas(64) std::atomic<size_t> head_; // consumer index
+  alignas(64) std::atomic<size_t> tail_; // producer index
+  alignas(64) size_t cached_head_;       // producer's view of head_
+  alignas(64) size_t cached_tail_;       // consumer's view of tail_
+};
+
+} // namespace arbitrage
@@ -0,0 +1,168 @@
+// symbol_table.h - Currency interning: fixed-size (exchange, currency) table
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+
+namespace arbitrage {
+
+// Interned currency identifier; doubles as the vertex index in the price
+// graph. 16 bits comfortably covers MAX_EXCHANGES * MAX_SYMBOLS.
+using CurrencyId = uint16_t;
+const CurrencyId INVALID_CURRENCY_ID = 0xFFFF;
+
+// Open-addressing table mapping (exchange, currency-code) to a dense
+// CurrencyId. This replaces the old hot-path pattern of building a
+// `currency + "_" + std::to_string(exchange)` std::string key and hashing it
+// through an unordered_map on every tick - two heap allocations plus a
+// string hash, all gone. Lookups are lock-free; the insertion mutex is only
+// taken the first time a currency is ever seen (subscription time in
+// practice). The table never rehashes, so slot addresses are stable.
+class SymbolTable {
+public:
+  static const size_t MAX_NAME_LEN = 11; // longest real code is ~10 chars
+  static const size_t TABLE_SIZE = 16384; // power of two, ~4x max entries
+
+  SymbolTable() : count_(0) {
+    for (auto &slot : slots_) {
+      slot.state.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  // Look up or assign the id for `currency` (not necessarily
+  // NUL-terminated; `len` chars) on `exchange`. Returns
+  // INVALID_CURRENCY_ID if the name is too long or the table is full.
+  CurrencyId intern(const char *currency, size_t len, uint8_t exchange) {
+    if (len == 0 || len > MAX_NAME_LEN) {
+      return INVALID_CURRENCY_ID;
+    }
+
+    Key key{};
+    std::memcpy(key.name, currency, len);
+    key.exchange = exchange;
+
+    size_t idx = hash_key(key) & (TABLE_SIZE - 1);
+    for (size_t probe = 0; probe < TABLE_SIZE; ++probe) {
+      Slot &slot = slots_[(idx + probe) & (TABLE_SIZE - 1)];
+      uint8_t state = slot.state.load(std::memory_order_acquire);
+
+      if (state == 1) {
+        if (key_equal(slot.key, key)) {
+          return slot.id;
+        }
+        continue; // occupied by someone else, keep probing
+      }
+
+      // Empty slot: fall into the (rare) insertion path
+      return intern_slow(key);
+    }
+
+    return INVALID_CURRENCY_ID; // table full
+  }
+
+  CurrencyId intern(const std::string &currency, uint8_t exchange) {
+    return intern(currency.data(), currency.size(), exchange);
+  }
+
+  // Reverse lookup for display paths, e.g. "BTC_0". Cold path only.
+  std::string name(CurrencyId id) const {
+    if (id >= count_.load(std::memory_order_acquire)) {
+      return "UNKNOWN";
+    }
+    const Entry &entry = entries_[id];
+    return std::string(entry.name) + "_" + std::to_string(entry.exchange);
+  }
+
+  size_t size() const { return count_.load(std::memory_order_acquire); }
+
+  // Raw entry access for the snapshot codec (cold path): copies the
+  // NUL-padded currency code and exchange for `id`. False if unassigned.
+  bool entry(CurrencyId id, char name_out[MAX_NAME_LEN + 1],
+             uint8_t &exchange_out) const {
+    if (id >= count_.load(std::memory_order_acquire)) {
+      return false;
+    }
+    std::memcpy(name_out, entries_[id].name, MAX_NAME_LEN + 1);
+    exchange_out = entries_[id].exchange;
+    return true;
+  }
+
+private:
+  struct Key {
+    char name[MAX_NAME_LEN + 1]; // NUL-padded
+    uint8_t exchange;
+  };
+
+  struct Slot {
+    std::atomic<uint8_t> state; // 0 = empty, 1 = filled
+    Key key;
+    CurrencyId id;
+  };
+
+  struct Entry {
+    char name[MAX_NAME_LEN + 1];
+    uint8_t exchange;
+  };
+
+  static uint64_t hash_key(const Key &key) {
+    // FNV-1a over the padded name plus the exchange byte
+    uint64_t h = 14695981039346656037ULL;
+    for (size_t i = 0; i < sizeof(key.name); ++i) {
+      h = (h ^ static_cast<uint8_t>(key.name[i])) * 1099511628211ULL;
+    }
+    h = (h ^ key.exchange) * 1099511628211ULL;
+    return h;
+  }
+
+  static bool key_equal(const Key &a, const Key &b) {
+    return a.exchange == b.exchange &&
+           std::memcmp(a.name, b.name, sizeof(a.name)) == 0;
+  }
+
+  CurrencyId intern_slow(const Key &key) {
+    std::lock_guard<std::mutex> lock(insert_mutex_);
+
+    // Re-probe under the lock: another thread may have inserted meanwhile
+    size_t idx = hash_key(key) & (TABLE_SIZE - 1);
+    for (size_t probe = 0; probe < TABLE_SIZE; ++probe) {
+      Slot &slot = slots_[(idx + probe) & (TABLE_SIZE - 1)];
+      uint8_t state = slot.state.load(std::memory_order_relaxed);
+
+      if (state == 1) {
+        if (key_equal(slot.key, key)) {
+          return slot.id;
+        }
+        continue;
+      }
+
+      size_t id = count_.load(std::memory_order_relaxed);
+      if (id >= MAX_ENTRIES) {
+        return INVALID_CURRENCY_ID;
+      }
+
+      slot.key = key;
+      slot.id = static_cast<CurrencyId>(id);
+      std::memcpy(entries_[id].name, key.name, sizeof(key.name));
+      entries_[id].exchange = key.exchange;
+
+      // Publish: readers that see state == 1 see the full key and entry
+      slot.state.store(1, std::memory_order_release);
+      count_.store(id + 1, std::memory_order_release);
+      return static_cast<CurrencyId>(id);
+    }
+
+    return INVALID_CURRENCY_ID;
+  }
+
+  static const size_t MAX_ENTRIES = 4096; // MAX_EXCHANGES * MAX_SYMBOLS
+
+  Slot slots_[TABLE_SIZE];
+  Entry entries_[MAX_ENTRIES];
+  std::atomic<size_t> count_;
+  std::mutex insert_mutex_;
+};
+
+} // namespace arbitrage
@@ -0,0 +1,274 @@
+// thread_topology.cpp - sysfs parsing and role-to-cpu assignment
+#include "thread_topology.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <unistd.h>
+
+namespace arbitrage {
+
+namespace {
+
+// Read a small sysfs file into `out`; false if absent/unreadable
+bool read_sysfs(const std::string &path, std::string &out) {
+  FILE *f = std::fopen(path.c_str(), "r");
+  if (f == nullptr) {
+    return false;
+  }
+  char buf[256];
+  size_t n = std::fread(buf, 1, sizeof(buf) - 1, f);
+  std::fclose(f);
+  buf[n] = '\0';
+  out.assign(buf);
+  while (!out.empty() && (out.back() == '\n' || out.back() == ' ')) {
+    out.pop_back();
+  }
+  return true;
+}
+
+long read_sysfs_long(const std::string &path, long fallback) {
+  std::string text;
+  if (!read_sysfs(path, text) || text.empty()) {
+    return fallback;
+  }
+  return std::strtol(text.c_str(), nullptr, 10);
+}
+
+// Parse the kernel's cpulist format ("0-3,8,10-11") into cpu ids
+std::vector<int> parse_cpu_list(const std::string &text) {
+  std::vector<int> cpus;
+  const char *p = text.c_str();
+  while (*p != '\0') {
+    char *end = nullptr;
+    long lo = std::strtol(p, &end, 10);
+    if (end == p) {
+      break;
+    }
+    long hi = lo;
+    p = end;
+    if (*p == '-') {
+      hi = std::strtol(p + 1, &end, 10);
+      p = end;
+    }
+    for (long c = lo; c <= hi; ++c) {
+      cpus.push_back(static_cast<int>(c));
+    }
+    if (*p == ',') {
+      ++p;
+    }
+  }
+  return cpus;
+}
+
+// The last-level cache index under cache/ is not always index3 (no L3 on
+// some parts); take the unified cache with the highest level
+std::string llc_shared_list(int cpu) {
+  std::string best;
+  long best_level = -1;
+  for (int index = 0; index < 8; ++index) {
+    std::string base = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) +
+                       "/cache/index" + std::to_string(index) + "/";
+    std::string type;
+    if (!read_sysfs(base + "type", type)) {
+      break;
+    }
+    if (type != "Unified") {
+      continue;
+    }
+    long level = read_sysfs_long(base + "level", -1);
+    if (level > best_level) {
+      best_level = level;
+      read_sysfs(base + "shared_cpu_list", best);
+    }
+  }
+  return best;
+}
+
+} // namespace
+
+ThreadTopology::ThreadTopology() {
+  std::string online;
+  std::vector<int> cpu_ids;
+  if (read_sysfs("/sys/devices/system/cpu/online", online)) {
+    cpu_ids = parse_cpu_list(online);
+  }
+  if (cpu_ids.empty()) {
+    // No sysfs: flat fallback over whatever the libc reports
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    for (long c = 0; c < std::max(n, 1L); ++c) {
+      cpu_ids.push_back(static_cast<int>(c));
+    }
+  }
+
+  cpus_.reserve(cpu_ids.size());
+  for (int cpu : cpu_ids) {
+    std::string base = "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+    Cpu info;
+    info.cpu = cpu;
+    info.package = static_cast<int>(
+        read_sysfs_long(base + "/topology/physical_package_id", 0));
+    // Label each L3 domain by its lowest member cpu; falls back to the
+    // package when cache topology is not exported
+    std::vector<int> shared = parse_cpu_list(llc_shared_list(cpu));
+    info.l3_domain = shared.empty()
+                         ? info.package
+                         : *std::min_element(shared.begin(), shared.end());
+    cpus_.push_back(info);
+  }
+
+  // NUMA node membership from /sys/devices/system/node/nodeN/cpulist
+  int max_node = 0;
+  for (int node = 0;; ++node) {
+    std::string list;
+    if (!read_sysfs("/sys/devices/system/node/node" + std::to_string(node) +
+                        "/cpulist",
+                    list)) {
+      break;
+    }
+    for (int cpu : parse_cpu_list(list)) {
+      for (auto &info : cpus_) {
+        if (info.cpu == cpu) {
+          info.numa_node = node;
+        }
+      }
+    }
+    max_node = node;
+  }
+  numa_node_count_ = max_node + 1;
+}
+
+const ThreadTopology::Cpu *ThreadTopology::find(int cpu) const {
+  for (const auto &info : cpus_) {
+    if (info.cpu == cpu) {
+      return &info;
+    }
+  }
+  return nullptr;
+}
+
+bool ThreadTopology::has_cpu(int cpu) const { return find(cpu) != nullptr; }
+
+int ThreadTopology::numa_node_of(int cpu) const {
+  const Cpu *info = find(cpu);
+  return info != nullptr ? info->numa_node : 0;
+}
+
+bool ThreadTopology::same_l3(int a, int b) const {
+  const Cpu *ia = find(a);
+  const Cpu *ib = find(b);
+  if (ia == nullptr || ib == nullptr) {
+    return true; // unknown cpus: don't invent a distance
+  }
+  return ia->l3_domain == ib->l3_domain;
+}
+
+ThreadPlacement::ThreadPlacement(const Config::Threading &threading,
+                                 const ThreadTopology &topology) {
+  if (!threading.pin_threads) {
+    return;
+  }
+
+  // Candidate cpus: the configured affinity set, minus entries the box
+  // does not actually have (a 4-core config on a 1-core VM should pin to
+  // core 0, not fail three times out of four)
+  std::vector<int> cands;
+  for (uint8_t cpu : threading.cpu_affinity) {
+    if (topology.has_cpu(cpu)) {
+      cands.push_back(cpu);
+    }
+  }
+  if (cands.empty()) {
+    return; // nothing usable; leave everything unpinned
+  }
+  enabled_ = true;
+
+  // The processing thread anchors the layout: it is the single consumer
+  // of every ingestion ring and the writer of the graph
+  processing_cpu_ = cands[0];
+
+  std::vector<int> rest(cands.begin() + 1, cands.end());
+  if (rest.empty()) {
+    rest.push_back(processing_cpu_); // one usable cpu: everything shares it
+  }
+  // Order the remaining candidates by distance from the processing core:
+  // same L3 first, then same NUMA node, then cpu id. Hot roles are handed
+  // out from the front of this order, the server from the back.
+  std::stable_sort(rest.begin(), rest.end(), [&](int a, int b) {
+    auto key = [&](int cpu) {
+      return std::make_tuple(!topology.same_l3(processing_cpu_, cpu),
+                             topology.numa_node_of(cpu) !=
+                                 topology.numa_node_of(processing_cpu_),
+                             cpu);
+    };
+    return key(a) < key(b);
+  });
+
+  // Feed producers first - they share an SPSC ring with the processing
+  // consumer, so they get the cpus closest to it
+  for (size_t i = 0; i < threading.num_exchange_threads; ++i) {
+    feed_cpus_.push_back(rest[i % rest.size()]);
+  }
+  size_t next = threading.num_exchange_threads;
+  detection_cpu_ = rest[next++ % rest.size()];
+  size_t extra_workers = threading.num_processor_threads > 1
+                             ? static_cast<size_t>(
+                                   threading.num_processor_threads) - 1
+                             : 0;
+  for (size_t i = 0; i < extra_workers; ++i) {
+    worker_cpus_.push_back(rest[next++ % rest.size()]);
+  }
+  server_cpu_ = rest.back();
+}
+
+int ThreadPlacement::cpu_for(ThreadRole role, size_t index) const {
+  if (!enabled_) {
+    return -1;
+  }
+  switch (role) {
+  case ThreadRole::PROCESSING:
+    return processing_cpu_;
+  case ThreadRole::DETECTION:
+    return detection_cpu_;
+  case ThreadRole::DETECTION_WORKER:
+    return worker_cpus_.empty()
+               ? detection_cpu_
+               : worker_cpus_[index % worker_cpus_.size()];
+  case ThreadRole::FEED:
+    return feed_cpus_.empty() ? -1 : feed_cpus_[index % feed_cpus_.size()];
+  case ThreadRole::SERVER:
+    return server_cpu_;
+  }
+  return -1;
+}
+
+void ThreadPlacement::pin_current_thread(int cpu) {
+  if (cpu < 0) {
+    return;
+  }
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  CPU_SET(cpu, &cpuset);
+  pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset);
+}
+
+ScopedAffinity::ScopedAffinity(int cpu) {
+  if (cpu < 0) {
+    return;
+  }
+  if (pthread_getaffinity_np(pthread_self(), sizeof(saved_), &saved_) != 0) {
+    return;
+  }
+  active_ = true;
+  ThreadPlacement::pin_current_thread(cpu);
+}
+
+void ScopedAffinity::release() {
+  if (active_) {
+    pthread_setaffinity_np(pthread_self(), sizeof(saved_), &saved_);
+    active_ = false;
+  }
+}
+
+} // namespace arbitrage
@@ -0,0 +1,101 @@
+// thread_topology.h - CPU topology discovery and deliberate thread placement
+#pragma once
+
+#include "cpp-types-header.h"
+#include <pthread.h>
+#include <sched.h>
+#include <vector>
+
+namespace arbitrage {
+
+// Core / L3-domain / NUMA topology, read once at startup straight from
+// /sys/devices/system (no libnuma link dependency). On machines where
+// sysfs is unavailable or incomplete the discovery degrades to a flat
+// single-node view, which makes every placement decision below a no-op
+// rather than a wrong guess.
+class ThreadTopology {
+public:
+  ThreadTopology();
+
+  size_t cpu_count() const { return cpus_.size(); }
+  bool has_cpu(int cpu) const;
+  // NUMA node the cpu's memory controller belongs to (0 when unknown)
+  int numa_node_of(int cpu) const;
+  // Whether two cpus share a last-level cache domain
+  bool same_l3(int a, int b) const;
+  int numa_node_count() const { return numa_node_count_; }
+
+private:
+  struct Cpu {
+    int cpu = 0;
+    int package = 0;
+    int l3_domain = 0; // lowest cpu id sharing this L3 (domain label)
+    int numa_node = 0;
+  };
+  const Cpu *find(int cpu) const;
+
+  std::vector<Cpu> cpus_;
+  int numa_node_count_ = 1;
+};
+
+// The threads whose placement matters. Producer/consumer pairs of the
+// SPSC ingestion rings (FEED -> PROCESSING) are the latency-critical
+// relationship: a cross-L3 (worse: cross-socket) handoff roughly doubles
+// the tick enqueue-to-dequeue cost, so producers are placed in the
+// processing core's L3 domain first and everything else fills in behind.
+enum class ThreadRole : uint8_t {
+  PROCESSING,       // SPSC consumer, graph writer, cross-exchange scanner
+  DETECTION,        // detection pass coordinator (reads published graph)
+  DETECTION_WORKER, // DetectionPool workers, indexed
+  FEED,             // per-exchange producers (live handlers or simulator)
+  SERVER,           // dashboard epoll thread; least latency-critical
+};
+
+// Maps roles to cpus once at startup from Config::Threading and the
+// discovered topology. With pin_threads unset (or no usable cpus) every
+// lookup returns -1 and threads stay at the scheduler's mercy, matching
+// the old behavior.
+class ThreadPlacement {
+public:
+  ThreadPlacement(const Config::Threading &threading,
+                  const ThreadTopology &topology);
+
+  // Target cpu for a role (index distinguishes feeds / pool workers);
+  // -1 means leave the thread unpinned.
+  int cpu_for(ThreadRole role, size_t index = 0) const;
+
+  // Pin the calling thread; silently ignores cpu < 0 and cpus the
+  // kernel rejects (consistent with the pre-existing pinning sites)
+  static void pin_current_thread(int cpu);
+
+private:
+  bool enabled_ = false;
+  int processing_cpu_ = -1;
+  int detection_cpu_ = -1;
+  int server_cpu_ = -1;
+  std::vector<int> feed_cpus_;
+  std::vector<int> worker_cpus_;
+};
+
+// Pins the current thread for a scope and restores the original mask on
+// release. The engine constructor uses this so the big first-touch
+// allocations (graph buffers, ingestion rings) fault their pages on the
+// processing core's NUMA node - the kernel's default local-allocation
+// policy then does the "allocate from the local node" part without any
+// explicit mbind.
+class ScopedAffinity {
+public:
+  explicit ScopedAffinity(int cpu);
+  ~ScopedAffinity() { release(); }
+
+  ScopedAffinity(const ScopedAffinity &) = delete;
+  ScopedAffinity &operator=(const ScopedAffinity &) = delete;
+
+  void release();
+
+private:
+  cpu_set_t saved_;
+  bool active_ = false;
+};
+
+} // namespace arbitrage
@@ -0,0 +1,111 @@
+// tick_journal.h - Append-only binary tick log with mmap replay
+#pragma once
+
+#include "cpp-types-header.h"
+#include "spsc_queue.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace arbitrage {
+
+class ArbitrageEngine;
+
+// On-disk layout: one JournalHeader followed by fixed-size MarketTick
+// records. MarketTick is 64 bytes, trivially copyable and padding-stable
+// (static_asserts in cpp-types-header.h), so records are written and
+// mapped back verbatim - no serialization step on either side.
+struct JournalHeader {
+  static const uint64_t MAGIC = 0x314C4E524A425241ULL; // "ARBJRNL1"
+
+  uint64_t magic = MAGIC;
+  uint32_t version = 1;
+  uint32_t record_size = sizeof(MarketTick);
+};
+
+// Captures a copy of the tick stream to an append-only file without
+// touching the hot path: record() is one SPSC enqueue, and a dedicated
+// writer thread drains the queue into a large buffer that is flushed to
+// disk in block-sized writes. If the writer falls behind the queue fills
+// and ticks are dropped (counted) - journaling never applies
+// backpressure to the engine.
+class JournalWriter {
+public:
+  explicit JournalWriter(const std::string& path);
+  ~JournalWriter();
+
+  JournalWriter(const JournalWriter&) = delete;
+  JournalWriter& operator=(const JournalWriter&) = delete;
+
+  // False if the file could not be created.
+  bool ok() const { return fd_ >= 0; }
+
+  // Queue one tick for persistence. Safe from the single engine
+  // processing thread; never blocks.
+  void record(const MarketTick& tick);
+
+  // Flushes buffered records and closes the file. Called by the
+  // destructor; idempotent.
+  void close();
+
+  uint64_t ticks_written() const {
+    return ticks_written_.load(std::memory_order_relaxed);
+  }
+  uint64_t ticks_dropped() const {
+    return ticks_dropped_.load(std::memory_order_relaxed);
+  }
+
+private:
+  void writer_loop();
+  void flush_buffer();
+
+  int fd_ = -1;
+  std::atomic<bool> running_;
+  std::thread writer_thread_;
+
+  SpscQueue<MarketTick> queue_;
+  std::vector<MarketTick> buffer_; // staged records awaiting a block write
+
+  std::atomic<uint64_t> ticks_written_;
+  std::atomic<uint64_t> ticks_dropped_;
+
+  // Flush granularity: 16K records = 1MB per write()
+  static const size_t FLUSH_RECORDS = 16384;
+};
+
+// Memory-maps a captured journal and replays it through update_price().
+// MAX_SPEED pushes ticks as fast as the engine accepts them (performance
+// regression runs against identical input); ORIGINAL_TIMING sleeps to
+// reproduce the recorded inter-tick gaps (incident reproduction).
+class JournalReader {
+public:
+  enum class ReplayMode : uint8_t { MAX_SPEED, ORIGINAL_TIMING };
+
+  explicit JournalReader(const std::string& path);
+  ~JournalReader();
+
+  JournalReader(const JournalReader&) = delete;
+  JournalReader& operator=(const JournalReader&) = delete;
+
+  // False if the file is missing, truncated, or from a different layout
+  // version.
+  bool ok() const { return ticks_ != nullptr; }
+
+  size_t size() const { return count_; }
+  const MarketTick& tick(size_t i) const { return ticks_[i]; }
+
+  // Returns the number of ticks accepted by the engine (update_price can
+  // reject ticks when the ingestion queue is full).
+  uint64_t replay(ArbitrageEngine& engine, ReplayMode mode) const;
+
+private:
+  int fd_ = -1;
+  void* mapping_ = nullptr;
+  size_t mapping_size_ = 0;
+  const MarketTick* ticks_ = nullptr;
+  size_t count_ = 0;
+};
+
+} // namespace arbitrage
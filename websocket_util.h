@@ -0,0 +1,111 @@
+// websocket_util.h - Shared RFC 6455 handshake primitives
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace arbitrage {
+namespace ws {
+
+// Self-contained SHA-1 + base64 so neither the dashboard server nor the
+// exchange feed clients pull in a crypto library link dependency for 20
+// bytes of handshake digest.
+
+inline void sha1(const uint8_t *data, size_t len, uint8_t out[20]) {
+  uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476,
+                   0xC3D2E1F0};
+
+  uint64_t total_bits = static_cast<uint64_t>(len) * 8;
+  std::vector<uint8_t> msg(data, data + len);
+  msg.push_back(0x80);
+  while (msg.size() % 64 != 56) {
+    msg.push_back(0);
+  }
+  for (int i = 7; i >= 0; --i) {
+    msg.push_back(static_cast<uint8_t>(total_bits >> (i * 8)));
+  }
+
+  for (size_t chunk = 0; chunk < msg.size(); chunk += 64) {
+    uint32_t w[80];
+    for (int i = 0; i < 16; ++i) {
+      w[i] = (static_cast<uint32_t>(msg[chunk + i * 4]) << 24) |
+             (static_cast<uint32_t>(msg[chunk + i * 4 + 1]) << 16) |
+             (static_cast<uint32_t>(msg[chunk + i * 4 + 2]) << 8) |
+             static_cast<uint32_t>(msg[chunk + i * 4 + 3]);
+    }
+    for (int i = 16; i < 80; ++i) {
+      uint32_t v = w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16];
+      w[i] = (v << 1) | (v >> 31);
+    }
+
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+    for (int i = 0; i < 80; ++i) {
+      uint32_t f, k;
+      if (i < 20) {
+        f = (b & c) | (~b & d);
+        k = 0x5A827999;
+      } else if (i < 40) {
+        f = b ^ c ^ d;
+        k = 0x6ED9EBA1;
+      } else if (i < 60) {
+        f = (b & c) | (b & d) | (c & d);
+        k = 0x8F1BBCDC;
+      } else {
+        f = b ^ c ^ d;
+        k = 0xCA62C1D6;
+      }
+      uint32_t tmp = ((a << 5) | (a >> 27)) + f + e + k + w[i];
+      e = d;
+      d = c;
+      c = (b << 30) | (b >> 2);
+      b = a;
+      a = tmp;
+    }
+    h[0] += a;
+    h[1] += b;
+    h[2] += c;
+    h[3] += d;
+    h[4] += e;
+  }
+
+  for (int i = 0; i < 5; ++i) {
+    out[i * 4] = static_cast<uint8_t>(h[i] >> 24);
+    out[i * 4 + 1] = static_cast<uint8_t>(h[i] >> 16);
+    out[i * 4 + 2] = static_cast<uint8_t>(h[i] >> 8);
+    out[i * 4 + 3] = static_cast<uint8_t>(h[i]);
+  }
+}
+
+inline std::string base64_encode(const uint8_t *data, size_t len) {
+  static const char table[] =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string out;
+  out.reserve((len + 2) / 3 * 4);
+  for (size_t i = 0; i < len; i += 3) {
+    uint32_t v = static_cast<uint32_t>(data[i]) << 16;
+    if (i + 1 < len)
+      v |= static_cast<uint32_t>(data[i + 1]) << 8;
+    if (i + 2 < len)
+      v |= static_cast<uint32_t>(data[i + 2]);
+    out.push_back(table[(v >> 18) & 0x3F]);
+    out.push_back(table[(v >> 12) & 0x3F]);
+    out.push_back(i + 1 < len ? table[(v >> 6) & 0x3F] : '=');
+    out.push_back(i + 2 < len ? table[v & 0x3F] : '=');
+  }
+  return out;
+}
+
+// Sec-WebSocket-Accept value for a client key; used by the server to
+// answer an upgrade and by feed clients to verify the peer's answer.
+inline std::string websocket_accept_key(const std::string &client_key) {
+  static const char GUID[] = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+  std::string input = client_key + GUID;
+  uint8_t digest[20];
+  sha1(reinterpret_cast<const uint8_t *>(input.data()), input.size(), digest);
+  return base64_encode(digest, sizeof(digest));
+}
+
+} // namespace ws
+} // namespace arbitrage